@@ -1,26 +1,66 @@
 // clock.h was created by Mark Renard on 2/21/2020 and modified on 4/17/2020.
 //
 // This file defines a type used to simulate a clock in a shared memory region.
+// A time is a single count of nanoseconds, so arithmetic and comparisons are
+// inline integer operations. Seconds and nanoseconds are split out only when
+// a time is printed.
 
 #ifndef CLOCK_H
 #define CLOCK_H
 
+#include <stdint.h>
 #include <stdio.h>
 
-// Uses two unsigned ints as a clock
-typedef struct clock {
-	unsigned int seconds;
-	unsigned int nanoseconds;
-} Clock;
+#define NS_PER_SEC 1000000000ULL	// Nanoseconds in a second
+
+// Uses one count of nanoseconds as a clock
+typedef uint64_t Clock;
+
+// A clock of the given seconds and nanoseconds, usable as an initializer
+#define CLOCK(seconds, nanoseconds) \
+	((Clock)(seconds) * NS_PER_SEC + (Clock)(nanoseconds))
+
+// Returns a clock initialized to zero
+static inline Clock zeroClock(){
+	return 0;
+}
+
+// Returns a clock with passed values of seconds and nanoseconds
+static inline Clock newClock(unsigned int seconds, unsigned int nanoseconds){
+	return CLOCK(seconds, nanoseconds);
+}
+
+// Adds a time increment to a clock
+static inline void incrementClock(Clock * clock, const Clock increment){
+	*clock += increment;
+}
+
+// Returns -1 if the time on clk1 is less, 1 if it's greater, and 0 if equal
+static inline int clockCompare(const Clock clk1, const Clock clk2){
+	return (clk1 > clk2) - (clk1 < clk2);
+}
+
+// Returns the sum of two times
+static inline Clock clockSum(Clock t1, Clock t2){
+	return t1 + t2;
+}
+
+// Returns the difference of two times (t1 - t2), which t1 must not be before
+static inline Clock clockDiff(Clock t1, Clock t2){
+	return t1 - t2;
+}
+
+// Returns the whole seconds of a time
+static inline unsigned int clockSeconds(Clock clock){
+	return clock / NS_PER_SEC;
+}
+
+// Returns the nanoseconds of a time past its whole seconds
+static inline unsigned int clockNanoseconds(Clock clock){
+	return clock % NS_PER_SEC;
+}
 
-Clock zeroClock();
-Clock newClock(unsigned int seconds, unsigned int nanoseconds);
 Clock randomTime(Clock min, Clock max);
-void copyTime(Clock * dest, const Clock src);
-void incrementClock(Clock * clock, const Clock increment);
-int clockCompare(const Clock clk1, const Clock clk2);
-Clock clockSum(Clock t1, Clock t2);
-Clock clockDiff(Clock t1, Clock t2);
 long double clockRatio(Clock t1, Clock t2);
 void printTime(FILE * fp, const Clock clock);
 void printTimeln(FILE * fp, const Clock clock);
@@ -10,11 +10,20 @@
 #include <sys/msg.h>
 #include <sys/stat.h>
 
+#include "dimensions.h"
+
 
 // Miscelaneous
-#define NUM_RESOURCES 20 		// Total number of resource classes
-#define MAX_RUNNING 18 	 		// Max number of running child processes
-#define MAX_LAUNCHED 200		// Max total children launched
+#define NUM_RESOURCES (dims.numResources) // Total resource classes (-r)
+#define MAX_RUNNING (dims.maxRunning)	  // Max running child processes (-n)
+#define MAX_LAUNCHED (dims.maxLaunched)	  // Max total children launched (-t)
+
+#define DEFAULT_NUM_RESOURCES 20	// NUM_RESOURCES if -r is not given
+#define DEFAULT_MAX_RUNNING 18		// MAX_RUNNING if -n is not given
+#define DEFAULT_MAX_LAUNCHED 200	// MAX_LAUNCHED if -t is not given
+
+#define NUM_RESOURCES_LIMIT 1024	// Largest NUM_RESOURCES allowed
+#define MAX_RUNNING_LIMIT 32767		// Largest MAX_RUNNING, an int16_t simPid
 
 #define	MIN_INST 1			// Minimum instances of each resource
 #define MAX_INST 10			// Maximum instances of each resource
@@ -27,7 +36,6 @@
 #define BILLION 1000000000U		// The number of nanoseconds in a second
 #define MILLION 1000000U		// Number of nanoseconds per millisecond
 #define BUFF_SZ 100			// The size of character buffers 
-#define MSG_SZ 30			// Size of Message char arrays
 
 #define EMPTY (-1)			// pidArray value at unassigned index
 
@@ -46,14 +54,26 @@
 
 #define SLEEP_NS 500000			// Real sleep between simulation loops
 
+#define EVENT_QUEUE_SZ (MAX_RUNNING + 2)// Max pending events (EVENT_DRIVEN)
+
+#define MAX_KILL_SET 3			// Largest victim set "minset" tries
+#define MAX_KILL_SET_EVALS 1000		// Victim sets "minset" may evaluate
+
 #define USER_PROG_PATH "./userProgram"	// The path to the user program
+#define USER_THREAD_STACK_SZ (256 * 1024) // Stack of each THREADED_USERS thread
+#define COROUTINE_STACK_SZ (64 * 1024)	// Stack of each COROUTINE_USERS process
+#define COROUTINE_THREADS 4		// Threads running COROUTINE_USERS
 
 #define LOG_FILE_NAME "oss_log"		// The name of the output file
+#define LOG_RING_SZ (1 << 22)		// Bytes of queued records (ASYNC_LOG)
+#define LOG_WAKE_SZ (LOG_RING_SZ / 4)	// Queued bytes that wake the writer
+#define LOG_BATCH_SZ (1 << 16)		// Bytes per write of the log file
 
 
 // Used by userProgram.c
 #define TERMINATION_PROBABILITY 0.1	// Chance of terminating
 #define REQUEST_PROBABILITY 0.8		// Chance of request instead of release
+#define CLAIM_PROBABILITY 0.3		// Chance a class is in a claim (-a)
 
 #define MIN_CHECK_SEC 0			// Min time between decisions sec
 #define MIN_CHECK_NS 0			// Min time between decisions nanosec
@@ -72,8 +92,9 @@
 #define REPLY_MQ_KEY 38257848		// Message queue key for interrupts
 #define MQ_PERMS (S_IRUSR | S_IWUSR)	// Message queue permissions
 
-#define BASE_SEED 39393984		// Used in calls to srand
+#define RING_SZ 8			// Messages per ring, a power of 2
+#define CACHE_LINE_SZ 64		// Bytes per cache line
 
-#define KILL_MSG "k"			// Message oss uses to kill processes
+#define BASE_SEED 39393984		// Used in calls to srand
 
 #endif
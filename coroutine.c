@@ -0,0 +1,397 @@
+// coroutine.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines a scheduler for stackful coroutines built on ucontext.
+// Each scheduler thread owns a ring of ready coroutines protected by a mutex.
+// It runs them from the front, requeues one at the back when it yields, and
+// steals from the back of another thread's ring when its own is empty, so a
+// coroutine may resume on a different thread than the one it suspended on.
+// Parked coroutines are held by no ring until woken. Sleeping coroutines wait
+// in a heap ordered by wake time, which threads check against the clock.
+// A thread that finds nothing to run blocks on a futex until a coroutine is
+// made ready, or until whoever moves the clock sees a sleeper is due.
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <ucontext.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "coroutine.h"
+#include "dimensions.h"
+#include "futex.h"
+#include "perrorExit.h"
+#include "protectedClock.h"
+
+typedef struct worker {
+	pthread_t thread;		// Thread running the coroutines
+	ucontext_t context;		// Where its coroutines suspend to
+	pthread_mutex_t lock;		// Protects the ready ring
+	Coroutine ** ready;		// Ring of coroutines ready to run
+	int front;			// Index of the next to run
+	int count;			// Number in the ring
+} Worker;
+
+static Worker * workers;		// Scheduler threads
+static int numWorkers = 0;		// Number of scheduler threads
+static int capacity;			// Most coroutines in one ring
+static atomic_uint nextWorker;		// Ring given the next spawn
+static atomic_bool stopping;		// Scheduler threads should exit
+static atomic_uint readyEvents;		// Futex bumped when work may be ready
+static atomic_int idleWorkers;		// Threads blocked or about to block
+
+static ProtectedClock * simClock;	// Clock sleeping coroutines wait on
+static pthread_mutex_t sleepLock;	// Protects the sleeper heap
+static Coroutine ** sleepers;		// Min-heap of sleepers by wake time
+static int numSleepers = 0;		// Number in the heap
+static _Atomic Clock earliestSleeper;	// Wake time of the first sleeper
+
+static _Thread_local Coroutine * current;	// Coroutine being run
+
+// Tells blocked threads there may be work, waking one if any are idle
+static void signalWork(){
+	atomic_fetch_add(&readyEvents, 1);
+	if (atomic_load(&idleWorkers) > 0) futexWakeOne(&readyEvents);
+}
+
+// Adds a coroutine to the back of a worker's ring
+static void pushReady(Worker * w, Coroutine * co){
+	pthread_mutex_lock(&w->lock);
+
+	if (w->count == capacity)
+		perrorExit("pushReady - ready ring full");
+
+	w->ready[(w->front + w->count++) % capacity] = co;
+
+	pthread_mutex_unlock(&w->lock);
+
+	signalWork();
+}
+
+// Removes and returns the coroutine at the front of a worker's ring, or from
+// the back if stealing, or NULL if the ring is empty
+static Coroutine * popReady(Worker * w, bool stealing){
+	Coroutine * co = NULL;
+
+	pthread_mutex_lock(&w->lock);
+
+	if (w->count > 0 && stealing){
+		co = w->ready[(w->front + --w->count) % capacity];
+	} else if (w->count > 0){
+		co = w->ready[w->front];
+		w->front = (w->front + 1) % capacity;
+		w->count--;
+	}
+
+	pthread_mutex_unlock(&w->lock);
+	return co;
+}
+
+// Swaps two sleepers in the heap
+static void swapSleepers(int a, int b){
+	Coroutine * temp = sleepers[a];
+	sleepers[a] = sleepers[b];
+	sleepers[b] = temp;
+}
+
+// Publishes the wake time of the first sleeper. sleepLock is held.
+static void updateEarliestSleeper(){
+	atomic_store(&earliestSleeper, numSleepers > 0 
+		     ? sleepers[0]->wakeTime : UINT64_MAX);
+}
+
+// Returns true if sleeper a is due before sleeper b
+static bool dueBefore(int a, int b){
+	return clockCompare(sleepers[a]->wakeTime, sleepers[b]->wakeTime) < 0;
+}
+
+// Adds a coroutine to the sleeper heap
+static void pushSleeper(Coroutine * co){
+	int i;
+
+	pthread_mutex_lock(&sleepLock);
+
+	if (numSleepers == capacity)
+		perrorExit("pushSleeper - sleeper heap full");
+
+	i = numSleepers++;
+	sleepers[i] = co;
+	while (i > 0 && dueBefore(i, (i - 1) / 2)){
+		swapSleepers(i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+	updateEarliestSleeper();
+
+	pthread_mutex_unlock(&sleepLock);
+}
+
+// Moves every sleeper due by the current time to self's ring
+static void wakeSleepers(Worker * self){
+	int i, child;
+	Clock now = getPTime(simClock);
+
+	// Takes the lock only when the first sleeper is due
+	if (atomic_load(&earliestSleeper) > now) return;
+
+	pthread_mutex_lock(&sleepLock);
+
+	while (numSleepers > 0 
+	       && clockCompare(sleepers[0]->wakeTime, now) <= 0){
+		pushReady(self, sleepers[0]);
+
+		// Moves the last sleeper down from the top of the heap
+		sleepers[0] = sleepers[--numSleepers];
+		i = 0;
+		while ((child = 2 * i + 1) < numSleepers){
+			if (child + 1 < numSleepers && dueBefore(child + 1, child))
+				child++;
+			if (!dueBefore(child, i)) break;
+
+			swapSleepers(i, child);
+			i = child;
+		}
+	}
+	updateEarliestSleeper();
+
+	pthread_mutex_unlock(&sleepLock);
+}
+
+// Returns a coroutine from self's ring, or one stolen from another ring, or
+// NULL if none are ready
+static Coroutine * findWork(Worker * self){
+	Coroutine * co;
+	int i, w = self - workers;
+
+	if ((co = popReady(self, false)) != NULL) return co;
+
+	for (i = 1; i < numWorkers; i++)
+		if ((co = popReady(&workers[(w + i) % numWorkers], true)) 
+		    != NULL)
+			return co;
+
+	return NULL;
+}
+
+// Runs the entry of the coroutine the current thread is resuming, then returns
+// to whichever thread resumed it last
+static void trampoline(){
+	Coroutine * co = current;
+
+	co->entry(co->arg);
+	co->suspension = SUSPEND_RETURN;
+
+	setcontext(&co->worker->context);
+}
+
+// Files a coroutine that has just given up self's thread by how it did so
+static void fileSuspended(Worker * self, Coroutine * co){
+	int running = PARK_RUNNING;
+
+	switch (co->suspension){
+	case SUSPEND_YIELD:
+		pushReady(self, co);
+		break;
+
+	case SUSPEND_PARK:
+		// Runs again at once if woken since it last ran
+		if (!atomic_compare_exchange_strong(&co->parkState, &running,
+						    PARK_PARKED)){
+			atomic_store(&co->parkState, PARK_RUNNING);
+			pushReady(self, co);
+		}
+		break;
+
+	case SUSPEND_SLEEP:
+		pushSleeper(co);
+		break;
+
+	case SUSPEND_RETURN:
+		// Marks it finished only once off its stack
+		atomic_store(&co->finished, 1);
+		futexWakeOne(&co->finished);
+		break;
+	}
+}
+
+// Returns a coroutine to run, blocking until one is ready, or NULL once the
+// scheduler stops
+static Coroutine * awaitWork(Worker * self){
+	Coroutine * co;
+	unsigned int seen;
+
+	while (!atomic_load(&stopping)){
+		wakeSleepers(self);
+		if ((co = findWork(self)) != NULL) return co;
+
+		// Announces the wait, then rechecks so a signal cannot be missed
+		seen = atomic_load(&readyEvents);
+		atomic_fetch_add(&idleWorkers, 1);
+		atomic_thread_fence(memory_order_seq_cst);
+
+		wakeSleepers(self);
+		if ((co = findWork(self)) == NULL && !atomic_load(&stopping))
+			futexWait(&readyEvents, seen);
+
+		atomic_fetch_sub(&idleWorkers, 1);
+		if (co != NULL) return co;
+	}
+
+	return NULL;
+}
+
+// Runs ready coroutines until the scheduler stops, blocking when none are
+// ready
+static void * runWorker(void * arg){
+	Worker * self = arg;
+	Coroutine * co;
+
+	while ((co = awaitWork(self)) != NULL){
+
+		// Resumes the coroutine until it suspends or returns
+		co->worker = self;
+		current = co;
+		if (swapcontext(&self->context, &co->context) == -1)
+			perrorExit("runWorker - swapcontext failed");
+
+		fileSuspended(self, co);
+	}
+
+	return NULL;
+}
+
+// Gives up the calling coroutine's thread, filed according to how
+static void suspend(Suspension suspension){
+	Coroutine * co = current;
+
+	co->suspension = suspension;
+	if (swapcontext(&co->context, &co->worker->context) == -1)
+		perrorExit("suspend - swapcontext failed");
+}
+
+// Starts numThreads scheduler threads able to hold capacity coroutines, whose
+// sleepers wait on clock
+void startScheduler(int numThreads, int ringCapacity, 
+		    ProtectedClock * clock){
+	int i;
+
+	numWorkers = numThreads;
+	capacity = ringCapacity;
+	simClock = clock;
+	atomic_init(&nextWorker, 0);
+	atomic_init(&stopping, false);
+	atomic_init(&readyEvents, 0);
+	atomic_init(&idleWorkers, 0);
+	atomic_init(&earliestSleeper, UINT64_MAX);
+	workers = allocArray(numWorkers, sizeof(Worker));
+
+	pthread_mutex_init(&sleepLock, NULL);
+	sleepers = allocArray(capacity, sizeof(Coroutine *));
+
+	for (i = 0; i < numWorkers; i++){
+		pthread_mutex_init(&workers[i].lock, NULL);
+		workers[i].ready = allocArray(capacity, sizeof(Coroutine *));
+	}
+
+	// Starts the threads with signals blocked so oss handles them itself
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+
+	for (i = 0; i < numWorkers; i++)
+		if ((errno = pthread_create(&workers[i].thread, NULL, 
+					    runWorker, &workers[i])) != 0)
+			perrorExit("Failed to create scheduler thread");
+
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+}
+
+// Stops the scheduler threads and waits for them to exit
+void stopScheduler(){
+	int i;
+
+	atomic_store(&stopping, true);
+	atomic_fetch_add(&readyEvents, 1);
+	futexWakeAll(&readyEvents);
+
+	for (i = 0; i < numWorkers; i++)
+		if ((errno = pthread_join(workers[i].thread, NULL)) != 0)
+			perrorExit("Failed to join scheduler thread");
+}
+
+// Makes co run entry(arg) on its own stack and queues it to be run
+void spawnCoroutine(Coroutine * co, void (*entry)(void *), void * arg){
+	if (co->stack == NULL) co->stack = allocArray(COROUTINE_STACK_SZ, 1);
+
+	if (getcontext(&co->context) == -1)
+		perrorExit("spawnCoroutine - getcontext failed");
+
+	co->context.uc_stack.ss_sp = co->stack;
+	co->context.uc_stack.ss_size = COROUTINE_STACK_SZ;
+	co->context.uc_link = NULL;
+	makecontext(&co->context, trampoline, 0);
+
+	co->entry = entry;
+	co->arg = arg;
+	atomic_store(&co->parkState, PARK_RUNNING);
+	atomic_store(&co->finished, 0);
+
+	// Spreads new coroutines across the threads
+	pushReady(&workers[atomic_fetch_add(&nextWorker, 1) % numWorkers], co);
+}
+
+// Suspends the calling coroutine, which runs again once the others ready on
+// its thread have had a turn, or sooner on a thread that steals it
+void yieldCoroutine(){
+	suspend(SUSPEND_YIELD);
+}
+
+// Suspends the calling coroutine until wakeCoroutine is called on it. Returns
+// at once if it was woken since it last parked. May return without a wake, so
+// callers recheck what they wait for.
+void parkCoroutine(){
+	suspend(SUSPEND_PARK);
+}
+
+// Makes a parked coroutine ready, or makes its next park return at once
+void wakeCoroutine(Coroutine * co){
+	int state = atomic_load(&co->parkState);
+
+	while (true){
+		if (state == PARK_WOKEN) return;
+
+		if (state == PARK_PARKED){
+			if (atomic_compare_exchange_weak(&co->parkState, &state,
+							 PARK_RUNNING)){
+				pushReady(&workers[atomic_fetch_add(
+					  &nextWorker, 1) % numWorkers], co);
+				return;
+			}
+		} else if (atomic_compare_exchange_weak(&co->parkState, &state,
+							PARK_WOKEN)){
+			return;
+		}
+	}
+}
+
+// Suspends the calling coroutine until the clock reaches until
+void sleepCoroutine(Clock until){
+	current->wakeTime = until;
+	suspend(SUSPEND_SLEEP);
+}
+
+// Wakes a thread if the clock has reached the first sleeper's wake time, for
+// callers outside the scheduler that move the clock
+void wakeDueSleepers(){
+	atomic_thread_fence(memory_order_seq_cst);
+
+	if (atomic_load(&earliestSleeper) <= getPTime(simClock))
+		signalWork();
+}
+
+// Waits until co has returned and left its stack, so it can be spawned again
+void joinCoroutine(Coroutine * co){
+	while (atomic_load(&co->finished) == 0)
+		futexWait(&co->finished, 0);
+}
@@ -0,0 +1,54 @@
+// coroutine.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines stackful coroutines and the headers of a scheduler that
+// runs them on a small pool of threads. Each thread runs the coroutines in its
+// own ready queue in turn and steals from the others when its queue is empty.
+// A coroutine may park until another thread wakes it, or sleep until the
+// simulated clock reaches a time. Threads with nothing to run block until a
+// coroutine is made ready or, via wakeDueSleepers, the clock passes a sleeper.
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <ucontext.h>
+
+#include "clock.h"
+#include "protectedClock.h"
+
+struct worker;
+
+// How a coroutine last gave up its thread
+typedef enum suspension {
+	SUSPEND_YIELD, SUSPEND_PARK, SUSPEND_SLEEP, SUSPEND_RETURN
+} Suspension;
+
+// Whether a parked coroutine may run, changed by parkCoroutine & wakeCoroutine
+typedef enum parkState {
+	PARK_RUNNING, PARK_PARKED, PARK_WOKEN
+} ParkState;
+
+typedef struct coroutine {
+	ucontext_t context;		// Saved state while suspended
+	void * stack;			// Stack, reused each time it is spawned
+	void (*entry)(void *);		// Function the coroutine runs
+	void * arg;			// Argument passed to entry
+	struct worker * worker;		// Thread that last resumed it
+	Suspension suspension;		// Why it last gave up its thread
+	Clock wakeTime;			// Time a sleeping coroutine is due
+	atomic_int parkState;		// A ParkState
+	atomic_uint finished;		// Returned and off its stack, a futex
+} Coroutine;
+
+void startScheduler(int numThreads, int capacity, ProtectedClock * clock);
+void stopScheduler();
+void spawnCoroutine(Coroutine *, void (*entry)(void *), void * arg);
+void yieldCoroutine();
+void parkCoroutine();
+void wakeCoroutine(Coroutine *);
+void sleepCoroutine(Clock until);
+void wakeDueSleepers();
+void joinCoroutine(Coroutine *);
+
+#endif
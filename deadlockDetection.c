@@ -11,6 +11,8 @@
 
 #include "clock.h"
 #include "constants.h"
+#include "dimensions.h"
+#include "deadlockDetection.h"
 #include "logging.h"
 #include "matrixRepresentation.h"
 #include "message.h"
@@ -19,53 +21,160 @@
 #include "pidArray.h"
 #include "qMsg.h"
 #include "resourceDescriptor.h"
+#include "rowKernels.h"
+#include "stats.h"
+#include "victimPolicy.h"
+#include "waitForGraph.h"
 
 // True if all values in req are <= values in avail for one process
 static bool req_lt_avail ( const int*req, const int*avail, const int pnum, \
                     const int num_res )
 {
-    int i = 0 ;
-    for ( ; i < num_res; i++ )
-        if ( req[pnum*num_res+i] > avail[i] ) 
-            break;
-    
-    return ( i == num_res );
+    return rowFits ( &req[pnum*num_res], avail, num_res );
 }
 
-// Returns true if the system is in deadlock and logs deadlocked processes
-static bool deadlock ( const int*available, const int m, const int n, \
-                const int*request, const int*allocated , int * deadlocked) 
+// Sorts the processes waiting on resource r by increasing request for r. No
+// request or need exceeds MAX_INST, so a stable counting sort is used.
+static void sortWaiters(int * waiters, int count, const int * request, 
+			const int r, const int m)
 {
-    int  work[m];       // m resources
-    bool finish[n];     // n processes
-   
-    int i; 
-    for ( i = 0 ; i < m; i++ )
-	work[i] = available[i];
+    static int * sorted = NULL; // Too large for the stack at scale
+    int start[MAX_INST + 2] = { 0 };
+    int i, v;
+
+    if ( sorted == NULL ) sorted = allocArray ( MAX_RUNNING, sizeof(int) );
+
+    for ( i = 0; i < count; i++ )
+    {
+        v = request[waiters[i]*m+r];
+        if ( v < 0 || v > MAX_INST )
+            perrorExit ( "sortWaiters - request out of range" );
+        start[v + 1]++;
+    }
 
-    for ( i = 0 ; i < n; finish[i++] = false );
+    for ( v = 1; v <= MAX_INST + 1; v++ )
+        start[v] += start[v-1];
+
+    for ( i = 0; i < count; i++ )
+        sorted[start[request[waiters[i]*m+r]]++] = waiters[i];
+
+    for ( i = 0; i < count; i++ )
+        waiters[i] = sorted[i];
+}
+
+// State of the deadlock detection algorithm, kept between passes so that
+// detection can resume after a victim is killed.
+//
+// Instead of rescanning all processes each time one finishes, each process
+// waiting on resource r is listed under r in order of its request, along with
+// a count of the resources it is still waiting on. When work[r] grows, only
+// the front of the list for r is examined, so the scan is O(n*m) overall.
+typedef struct detection {
+    int m, n;            // m resources, n processes
+    const int*request;   // Request matrix
+    const int*allocated; // Allocation matrix
+
+    int*work;            // m resources
+    bool*finish;         // n processes
+
+    int*waiters;         // Processes waiting on each resource, by request
+    int*numWaiters;      // Number of processes waiting on each resource
+    int*nextWaiter;      // First waiter on each resource not yet satisfied
+    int*blocked;         // Number of resources each process is waiting on
+    int*ready;           // Stack of processes that can finish
+    int numReady;
+} Detection;
+
+// Marks a process finished, returns its allocation to work, and readies the
+// waiters it satisfies
+static void finishProcess ( Detection*d, const int p )
+{
+    const int m = d->m, n = d->n;
+    int i, q;
 
+    d->finish[p] = true;
+    rowAdd ( d->work, &d->allocated[p*m], m );
 
-    int p = 0;
-    for ( ; p < n; p++ )   // For each process
+    for ( i = 0 ; i < m; i++ )
     {
-        if ( finish[p] ) continue;
-        if ( req_lt_avail ( request, work, p, m ) )
+        if ( d->allocated[p*m+i] == 0 ) continue;
+
+        while ( d->nextWaiter[i] < d->numWaiters[i] )
         {
-            finish[p] = true;
+            q = d->waiters[i*n + d->nextWaiter[i]];
+            if ( d->request[q*m+i] > d->work[i] ) break;
+
+            d->nextWaiter[i]++;
+            if ( !d->finish[q] && --d->blocked[q] == 0 )
+                d->ready[d->numReady++] = q;
+        }
+    }
+}
+
+// Sets work to available and lists each process under the resources it waits on
+static void startDetection ( Detection*d, const int*available )
+{
+    const int m = d->m, n = d->n;
+    int i, p;
+
+    d->numReady = 0;
+
+    for ( i = 0 ; i < m; i++ )
+    {
+	d->work[i] = available[i];
+        d->numWaiters[i] = d->nextWaiter[i] = 0;
+    }
+
+    for ( p = 0; p < n; p++ )
+    {
+        d->finish[p] = false;
+        d->blocked[p] = 0;
 
-            for ( i = 0 ; i < m; i++ )
-                work[i] += allocated[p*m+i];
-            p = -1;
+        if ( req_lt_avail ( d->request, d->work, p, m ) )
+        {
+            d->ready[d->numReady++] = p;
+            continue;
         }
-        
+
+        for ( i = 0; i < m; i++ )
+            if ( d->request[p*m+i] > d->work[i] )
+            {
+                d->waiters[i*n + d->numWaiters[i]++] = p;
+                d->blocked[p]++;
+            }
+    }
+
+    for ( i = 0; i < m; i++ )
+        sortWaiters ( &d->waiters[i*n], d->numWaiters[i], d->request, i, m );
+}
+
+// Finishes ready processes until none remain
+static void runDetection ( Detection*d )
+{
+    int p;
+
+    while ( d->numReady > 0 )
+    {
+        p = d->ready[--d->numReady];
+        if ( !d->finish[p] ) finishProcess ( d, p );
     }
+}
+
+// Finishes ready processes until none remain, returns true if any are left
+// unfinished and marks them in deadlocked, logging them
+static bool deadlock ( Detection*d, int * deadlocked )
+{
+    int p, i;
+
+    runDetection ( d );
 
     bool deadlock = false;
     int deadPids[MAX_RUNNING];
     i = 0;
-    for ( p = 0; p < n; p++ )
-        if ( ! finish[p] )
+    for ( p = 0; p < d->n; p++ )
+    {
+        deadlocked[p] = 0;
+        if ( ! d->finish[p] )
         {
 
             deadlocked[p] = 1;
@@ -73,6 +182,7 @@ static bool deadlock ( const int*available, const int m, const int n, \
             deadlock = true;
 
         }
+    }
 
     // Prints deadlocked processes to the log file
     logDeadlockedProcesses(deadPids, i);
@@ -81,81 +191,204 @@ static bool deadlock ( const int*available, const int m, const int n, \
     return ( deadlock );
 }
 
-// Sets all the values in a vector to n
-static void initVector(int * vector, int size, int n){
-	int i = 0;
-	for ( ; i < size; i++){
-		vector[i] = n;
-	}
+// Returns true if the system would still be deadlocked after the processes
+// marked in removed were killed
+bool deadlockedWithout(const int * removed){
+	static int * waiters = NULL; // Too large for the stack at scale
+	int work[NUM_RESOURCES];
+	bool finish[MAX_RUNNING];
+	int numWaiters[NUM_RESOURCES];
+	int nextWaiter[NUM_RESOURCES];
+	int blocked[MAX_RUNNING];
+	int ready[MAX_RUNNING];
+	int p;
+
+	if (waiters == NULL)
+		waiters = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+
+	Detection d = { NUM_RESOURCES, MAX_RUNNING, liveRequest(), 
+			liveAllocated(), work, finish, waiters, numWaiters,
+			nextWaiter, blocked, ready, 0 };
+
+	startDetection(&d, liveAvailable());
+
+	// Killing a process returns its allocation just as finishing does
+	for (p = 0; p < MAX_RUNNING; p++)
+		if (removed[p] && !finish[p]) finishProcess(&d, p);
+
+	runDetection(&d);
+
+	for (p = 0; p < MAX_RUNNING; p++)
+		if (!finish[p]) return true;
+
+	return false;
 }
 
-// Kills process with resources that meet a request or the greatest allocation
-static void killAProcess(pid_t * pidArray, int * deadlocked, 
-			 Message * messages,
-			 ResourceDescriptor * resources){
-	int killPid = -1;	// Logical pid of process to kill
-	int maxAlloc = 0;	// Greatest num allocated of a needed resource
-	int maxPid = -1;	// simPid of process with greatest allocation
-
-	int quant;		// Quantity of requested resource
-	int rNum;		// Index of requested resource
-	int p, k;		// Index variables
-
-	// Loops through all logical pids
-	for (p = 0; p < MAX_RUNNING; p++){
-		if (deadlocked[p]){
-
-			// Gets request values
-			rNum = messages[p].rNum;
-			quant = messages[p].quantity;
-
-			// Looks for deadlocked process that can meet request
-			for (k = 0; k < MAX_RUNNING; k++){
-			    if (deadlocked[k] && k != p){
-
-				// Checks for new maximum allocation		
-				if (resources[rNum].allocations[k] > maxAlloc){
-				    maxAlloc = resources[rNum].allocations[k];
-				    maxPid = k;
-				}
-
-				// Breaks if process k has enough
-				if (resources[rNum].allocations[k] >= quant){
-				    killPid = k;
-				    k = MAX_RUNNING;
-				    p = MAX_RUNNING;
-				}
-			    }
-			}
+// Waiter lists keyed on need for the live state, shared by every safety check
+// until the state changes. Each process with need for resource r is listed
+// under r, so a check that lowers work for r only has to block the waiters
+// whose need no longer fits.
+static struct needIndex {
+	bool built;
+	unsigned long version;	// stateVersion() when the lists were built
+	int * waiters;		// Processes needing each resource, by need
+	int * numWaiters;	// Number of processes needing each resource
+	int * firstShort;	// First waiter on each resource short of available
+	int * blocked;		// Number of resources each process is short of
+} needIndex;
+
+// Rebuilds the need waiter lists if the live state changed since they were
+// built
+static void indexNeed(){
+	const int m = NUM_RESOURCES, n = MAX_RUNNING;
+	const int * need = liveNeed();
+	const int * available = liveAvailable();
+	struct needIndex * x = &needIndex;
+	int * list;
+	int p, r, i;
+
+	if (x->built && x->version == stateVersion()) return;
+
+	if (x->waiters == NULL){
+		x->waiters = allocArray(m * n, sizeof(int));
+		x->numWaiters = allocArray(m, sizeof(int));
+		x->firstShort = allocArray(m, sizeof(int));
+		x->blocked = allocArray(n, sizeof(int));
+	}
+
+	for (r = 0; r < m; r++) x->numWaiters[r] = 0;
+
+	for (p = 0; p < n; p++){
+		x->blocked[p] = 0;
+		for (r = 0; r < m; r++){
+			if (need[p*m + r] == 0) continue;
+
+			x->waiters[r*n + x->numWaiters[r]++] = p;
+			if (need[p*m + r] > available[r]) x->blocked[p]++;
 		}
 	}
 
-	// Sets killPid if process with sufficient resources wasn't found
-	if (killPid == -1) killPid = maxPid;
+	for (r = 0; r < m; r++){
+		list = &x->waiters[r*n];
+		sortWaiters(list, x->numWaiters[r], need, r, m);
 
-	// This should never happen
-	if (killPid == -1) perrorExit("killAProcess - no pid selected");
-	if (pidArray[killPid] == EMPTY) perrorExit("killAProcess - bad pid");
+		i = 0;
+		while (i < x->numWaiters[r] && need[list[i]*m + r] <= available[r])
+			i++;
+		x->firstShort[r] = i;
+	}
 
-	// Kills the process
-	killProcess(killPid, pidArray[killPid]);
+	x->built = true;
+	x->version = stateVersion();
+}
 
-	// Removes the pid from the array
+// Returns true if granting quantity of rNum to simPid leaves the system safe,
+// assuming it was safe before. Once simPid could finish and return its
+// allocation, every process that could finish before the grant still can, so
+// the search stops there instead of building a whole safe sequence.
+//
+// The search is the detection algorithm run on the need matrix, so finishing
+// a process only examines the waiters its allocation can unblock.
+bool grantIsSafe(int simPid, int rNum, int quantity, bool shareable){
+	const int m = NUM_RESOURCES, n = MAX_RUNNING;
+	const int * need = liveNeed();
+	const int * available = liveAvailable();
+	int work[NUM_RESOURCES];	// Available to processes finishing
+	int needAfter[NUM_RESOURCES];	// Need of simPid after the grant
+	int nextWaiter[NUM_RESOURCES];
+	bool finish[MAX_RUNNING];
+	int blocked[MAX_RUNNING];
+	int ready[MAX_RUNNING];
+	int * list;
+	int p, r, i;
+
+	for (r = 0; r < m; r++){
+		work[r] = available[r];
+		needAfter[r] = need[simPid*m + r];
+	}
+	needAfter[rNum] -= quantity;
+	if (!shareable) work[rNum] -= quantity;
+
+	// Needs no search if simPid could finish at once
+	if (rowFits(needAfter, work, m)) return true;
+
+	indexNeed();
+
+	Detection d = { m, n, need, liveAllocated(), work, finish,
+			needIndex.waiters, needIndex.numWaiters, nextWaiter,
+			blocked, ready, 0 };
+
+	for (r = 0; r < m; r++) nextWaiter[r] = needIndex.firstShort[r];
+	for (p = 0; p < n; p++){
+		finish[p] = (p == simPid);
+		blocked[p] = needIndex.blocked[p];
+	}
+
+	// Blocks the waiters on rNum whose need the grant leaves short
+	list = &needIndex.waiters[rNum*n];
+	for (i = nextWaiter[rNum]; i > 0; i--){
+		if (need[list[i-1]*m + rNum] <= work[rNum]) break;
+		blocked[list[i-1]]++;
+	}
+	nextWaiter[rNum] = i;
+
+	for (p = 0; p < n; p++)
+		if (!finish[p] && blocked[p] == 0) ready[d.numReady++] = p;
+
+	// Finishes other processes until simPid could finish or none can
+	while (d.numReady > 0){
+		p = ready[--d.numReady];
+		if (finish[p]) continue;
+
+		finishProcess(&d, p);
+		if (rowFits(needAfter, work, m)) return true;
+	}
+
+	return false;
+}
+
+// Kills a process, releasing its resources, and removes it from pidArray
+static void killAProcess(pid_t * pidArray, int killPid){
+	killProcess(killPid, pidArray[killPid]);
 	pidArray[killPid] = EMPTY;
+}
 
+// Logs the pids of processes marked in a deadlocked vector
+static void logDeadlockedVector(const int * deadlocked){
+	int deadPids[MAX_RUNNING];
+	int p, i = 0;
 
-	
+	for (p = 0; p < MAX_RUNNING; p++)
+		if (deadlocked[p]) deadPids[i++] = p;
+
+	logDeadlockedProcesses(deadPids, i);
 }
 
-// Converts values in resource descriptors and messages to matrix form
-static void updateMatrices(const ResourceDescriptor * resources, 
-			   int * allocated, int * request, int * available,
-			   int * deadlocked){
-	
-	setAllocated(resources, allocated);
-	setRequest(resources, request);
-	setAvailable(resources, available);
-	initVector(deadlocked, MAX_RUNNING, 0);
+// Detects deadlock with the wait-for graph when every waiting process waits on
+// a single-instance class and no matrix pass is in progress, and with the
+// matrix algorithm otherwise, resuming a pass if one was started. Points
+// victims at the processes a victim should be chosen from.
+static bool detect(Detection * d, bool * started, int * deadlocked, 
+		   int * cycle, int ** victims){
+	bool found;
+
+	if (!*started && graphApplies()){
+		statsGraphDetectionRun();
+
+		// Only processes on a cycle need to be considered as victims
+		found = graphDeadlock(deadlocked, cycle);
+		logDeadlockedVector(deadlocked);
+		*victims = cycle;
+		return found;
+	}
+
+	if (!*started){
+		startDetection(d, liveAvailable());
+		*started = true;
+	}
+
+	*victims = deadlocked;
+	return deadlock(d, deadlocked);
 }
 
 // Returns the number of currently running processes
@@ -168,25 +401,45 @@ static int numRunning(pid_t * pidArray){
 }
 
 // Detects and resolves deadlock - returns num killed and removes pids
-int resolveDeadlock(pid_t * pidArray, ResourceDescriptor * resources,
-		    Message * messages){
-
-	int allocated[NUM_RESOURCES * MAX_RUNNING];	// Resource allocation
-	int request[NUM_RESOURCES * MAX_RUNNING];	// Current requests
-	int available[NUM_RESOURCES];			// Available resources
+int resolveDeadlock(pid_t * pidArray, ResourceTable * resources,
+		    Message * messages, const Clock * launchTimes){
 
 	int deadlocked[MAX_RUNNING]; // Whether each pid is deadlocked
+	int cycle[MAX_RUNNING];	     // Whether each pid is on a wait-for cycle
+	int * victims;		     // Processes to choose a victim from
+	int victim;		     // simPid of the process to kill
+
+	// Storage for the matrix algorithm, reused after each kill
+	static int * waiters = NULL; // Too large for the stack at scale
+	int work[NUM_RESOURCES];
+	bool finish[MAX_RUNNING];
+	int numWaiters[NUM_RESOURCES];
+	int nextWaiter[NUM_RESOURCES];
+	int blocked[MAX_RUNNING];
+	int ready[MAX_RUNNING];
+
+	if (waiters == NULL)
+		waiters = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+
+	Detection d = { NUM_RESOURCES, MAX_RUNNING, liveRequest(), 
+			liveAllocated(), work, finish, waiters, numWaiters,
+			nextWaiter, blocked, ready, 0 };
+	bool started = false;	     // Whether a matrix pass has been started
+
+	VictimContext context = { NULL, messages, liveAllocated(), 
+				  launchTimes };
 
 	int killed = 0;				   // Num terminated processes
 	int runningAtStart = numRunning(pidArray); // Num processes running
 
-	// Initializes vectors
-	updateMatrices(resources, allocated, request, available, deadlocked);
+#ifdef DEBUG
+	if (!liveMatricesMatch(resources))
+		perrorExit("resolveDeadlock - live matrices out of date");
+#endif
 
 	// If deadlock exists, repeatedly kills processes until resolved
 	bool deadlockDetected = false;
-	while(deadlock(available, NUM_RESOURCES, MAX_RUNNING, request,
-		       allocated, deadlocked)){
+	while(detect(&d, &started, deadlocked, cycle, &victims)){
 
 		// Prints resolution message once
 		if (!deadlockDetected){
@@ -194,11 +447,22 @@ int resolveDeadlock(pid_t * pidArray, ResourceDescriptor * resources,
 			deadlockDetected = true;
 		}
 
-		killAProcess(pidArray, deadlocked, messages, resources);
-		killed++;
+		// Chooses a victim with the selected policy
+		context.candidates = victims;
+		victim = selectVictim(&context);
+
+		// This should never happen
+		if (victim == -1) perrorExit("resolveDeadlock - no pid selected");
+		if (pidArray[victim] == EMPTY) 
+			perrorExit("resolveDeadlock - bad pid");
 
-		// Updates vectors	
-		updateMatrices(resources, allocated, request, available, deadlocked);
+		// Resumes detection as if the victim finished, since killing
+		// it returns the same allocation, before the kill clears it
+		if (started) finishProcess(&d, victim);
+
+		// Killing releases the victim's resources & updates matrices
+		killAProcess(pidArray, victim);
+		killed++;
 	}
 
 	if (deadlockDetected)
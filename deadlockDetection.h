@@ -1,18 +1,26 @@
 // deadlockDetection.h was created by Mark Renard on 4/14/2020.
 //
 // This file contains a header for a functon which repeatedly detects deadlock
-// and attempts to resolve it by killing a process.
+// and attempts to resolve it by killing a process, and for a function used by
+// victim policies to test the effect of killing a set of processes, and for
+// the safety check used to avoid deadlock instead.
 
 #ifndef DEADLOCKDETECTION_H
 #define DEADLOCKDETECTION_H
 
+#include "clock.h"
 #include "resourceDescriptor.h"
 #include "message.h"
 
+#include <stdbool.h>
 #include <sys/types.h>
 
 
-int resolveDeadlock(pid_t * pidArray, volatile ResourceDescriptor * resources,
-                    volatile Message * messages);
+int resolveDeadlock(pid_t * pidArray, ResourceTable * resources,
+                    Message * messages, const Clock * launchTimes);
+
+bool deadlockedWithout(const int * removed);
+
+bool grantIsSafe(int simPid, int rNum, int quantity, bool shareable);
 
 #endif
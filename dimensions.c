@@ -0,0 +1,31 @@
+// dimensions.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines the dimensions of the simulation and a function used to
+// allocate the arrays they size.
+
+#include <stdlib.h>
+
+#include "constants.h"
+#include "dimensions.h"
+#include "perrorExit.h"
+
+Dimensions dims = {DEFAULT_NUM_RESOURCES, DEFAULT_MAX_RUNNING, 
+		   DEFAULT_MAX_LAUNCHED};
+
+// Sets the dimensions, returns false and leaves them unchanged if out of range
+bool setDimensions(Dimensions d){
+	if (d.numResources < 1 || d.numResources > NUM_RESOURCES_LIMIT
+	    || d.maxRunning < 1 || d.maxRunning > MAX_RUNNING_LIMIT
+	    || d.maxLaunched < 1)
+		return false;
+
+	dims = d;
+	return true;
+}
+
+// Returns zeroed memory for count elements of size bytes or exits on failure
+void * allocArray(int count, size_t size){
+	void * array = calloc(count, size);
+	if (array == NULL) perrorExit("allocArray - calloc failed");
+	return array;
+}
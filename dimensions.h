@@ -0,0 +1,27 @@
+// dimensions.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines the dimensions of the simulation, which oss reads from the
+// command line and stores at the start of shared memory for user processes.
+// NUM_RESOURCES, MAX_RUNNING and MAX_LAUNCHED in constants.h read them.
+
+#ifndef DIMENSIONS_H
+#define DIMENSIONS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct dimensions {
+	int numResources;	// Total number of resource classes
+	int maxRunning;		// Max number of running child processes
+	int maxLaunched;	// Max total children launched
+} Dimensions;
+
+extern Dimensions dims;
+
+// Sets the dimensions, returns false and leaves them unchanged if out of range
+bool setDimensions(Dimensions);
+
+// Returns zeroed memory for count elements of size bytes or exits on failure
+void * allocArray(int count, size_t size);
+
+#endif
@@ -0,0 +1,81 @@
+// eventQueue.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines functions that operate on a binary min-heap of simulation
+// events keyed by the simulated time at which each event is due.
+
+#include "clock.h"
+#include "dimensions.h"
+#include "eventQueue.h"
+#include "perrorExit.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Returns true if event a is due before event b
+static bool precedes(const Event * a, const Event * b){
+	int cmp = clockCompare(a->time, b->time);
+	if (cmp != 0) return cmp < 0;
+
+	// Events due at the same time are handled in the order they were pushed
+	return a->order < b->order;
+}
+
+// Swaps two events in the heap
+static void swap(Event * a, Event * b){
+	Event temp = *a;
+	*a = *b;
+	*b = temp;
+}
+
+// Allocates room for EVENT_QUEUE_SZ events and sets the count of events to 0
+void initEventQueue(EventQueue * q){
+	q->events = allocArray(EVENT_QUEUE_SZ, sizeof(Event));
+	q->count = 0;
+	q->pushed = 0;
+}
+
+// Adds an event to the heap, moving it up until its parent is due first
+void pushEvent(EventQueue * q, Clock time, EventType type, int simPid){
+	if (q->count >= EVENT_QUEUE_SZ)
+		perrorExit("pushEvent called on full event queue");
+
+	int i = q->count++;
+	q->events[i].time = time;
+	q->events[i].type = type;
+	q->events[i].simPid = simPid;
+	q->events[i].order = q->pushed++;
+
+	while (i > 0 && precedes(&q->events[i], &q->events[(i - 1) / 2])){
+		swap(&q->events[i], &q->events[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+}
+
+// Removes and returns the event that is due first
+Event popEvent(EventQueue * q){
+	if (q->count <= 0)
+		perrorExit("Called popEvent on empty event queue");
+
+	Event first = q->events[0];
+	q->events[0] = q->events[--q->count];
+
+	// Moves the former last event down until both children are due later
+	int i = 0, child;
+	while ((child = 2 * i + 1) < q->count){
+		if (child + 1 < q->count
+		    && precedes(&q->events[child + 1], &q->events[child]))
+			child++;
+
+		if (!precedes(&q->events[child], &q->events[i])) break;
+
+		swap(&q->events[i], &q->events[child]);
+		i = child;
+	}
+
+	return first;
+}
+
+// Returns the event that is due first without removing it, or NULL if empty
+const Event * peekEvent(const EventQueue * q){
+	return q->count > 0 ? &q->events[0] : NULL;
+}
@@ -0,0 +1,34 @@
+// eventQueue.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines a time-ordered queue of simulation events used by oss to
+// advance the system clock directly to the next event in event-driven mode.
+
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include "clock.h"
+#include "constants.h"
+
+typedef enum eventType {
+	FORK_EVENT, DETECTION_EVENT, MESSAGE_EVENT
+} EventType;
+
+typedef struct event {
+	Clock time;			// Simulated time the event is due
+	EventType type;			// What happens when the event is due
+	int simPid;			// simPid of sender for message events
+	unsigned long order;		// Breaks ties between equal times
+} Event;
+
+typedef struct eventQueue {
+	Event * events;			// Binary min-heap ordered by time
+	int count;			// Number of events in the heap
+	unsigned long pushed;		// Total events ever pushed
+} EventQueue;
+
+void initEventQueue(EventQueue *);
+void pushEvent(EventQueue *, Clock time, EventType type, int simPid);
+Event popEvent(EventQueue *);
+const Event * peekEvent(const EventQueue *);
+
+#endif
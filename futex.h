@@ -0,0 +1,30 @@
+// futex.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines wrappers for the futex calls used to sleep on and wake a
+// word in shared memory, which work between processes and between threads.
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// Sleeps while the futex word equals expected (shared between processes)
+static inline void futexWait(atomic_uint * word, unsigned int expected){
+	syscall(SYS_futex, word, FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+// Wakes at most one process sleeping on the futex word
+static inline void futexWakeOne(atomic_uint * word){
+	syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+// Wakes every process sleeping on the futex word
+static inline void futexWakeAll(atomic_uint * word){
+	syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+#endif
@@ -2,36 +2,82 @@
 //
 // This file contains the definition of a shared memory function specific to
 // assignment 5. This function is used by oss.c and userProgram.c.
+//
+// The region begins with the Dimensions of the simulation, which oss writes
+// when it creates the region and user processes read to find everything else.
+
+#include <sys/ipc.h>
 
 #include "clock.h"
 #include "constants.h"
+#include "dimensions.h"
 #include "message.h"
 #include "protectedClock.h"
 #include "resourceDescriptor.h"
 #include "sharedMemory.h"
+#include "timerWake.h"
+#include "transport.h"
+
+// Rounds a byte offset up to the next multiple of CACHE_LINE_SZ
+static int alignToCacheLine(int offset){
+	return (offset + CACHE_LINE_SZ - 1) / CACHE_LINE_SZ * CACHE_LINE_SZ;
+}
 
 int getSharedMemoryPointers(char ** shm,  ProtectedClock ** systemClock,
-			     ResourceDescriptor ** resources,
-			     Message ** messages, int flags) {
+			     ResourceTable * resources,
+			     Message ** messages, uint8_t ** claims, 
+			     Channel ** channels, int flags) {
+
+	// Attaches to existing shared memory and reads its dimensions
+	if (!(flags & IPC_CREAT)){
+		*shm = sharedMemory(0, flags);
+		dims = *(Dimensions *)(*shm);
+	}
 
-	// Computes size of the shared memory region
-	int shmSize = sizeof(ProtectedClock) \
-		      + sizeof(ResourceDescriptor) * NUM_RESOURCES \
-                      + sizeof(Message) * MAX_RUNNING;
+	// Computes the offset of each part of the shared memory region
+	int clockOffset = alignToCacheLine(sizeof(Dimensions));
+	int resourceOffset = alignToCacheLine(clockOffset 
+					      + sizeof(ProtectedClock));
+	int messageOffset = alignToCacheLine(resourceOffset
+		+ resourceTableSize());
+	int claimOffset = alignToCacheLine(messageOffset
+		+ sizeof(Message) * MAX_RUNNING);
+	int channelOffset = alignToCacheLine(claimOffset
+		+ sizeof(uint8_t) * MAX_RUNNING * NUM_RESOURCES);
+	int timerOffset = alignToCacheLine(channelOffset
+		+ sizeof(Channel) * MAX_RUNNING);
+#ifdef TIMER_WAKE
+	int shmSize = timerOffset + timerWakeSize();
+#else
+	int shmSize = timerOffset;
+#endif
 
- 	// Attaches to shared memory
-        *shm = sharedMemory(shmSize, flags);
+	// Creates shared memory and records the dimensions for user processes
+	if (flags & IPC_CREAT){
+		*shm = sharedMemory(shmSize, flags);
+		*(Dimensions *)(*shm) = dims;
+	}
 
 	// Gets pointer to simulated system clock
-	*systemClock = (ProtectedClock *)(*shm);
+	*systemClock = (ProtectedClock *)(*shm + clockOffset);
 
-	// Gets pointer to first resource descriptor
-	*resources = (ResourceDescriptor *)(*shm + sizeof(ProtectedClock));
+	// Gets pointers to the arrays of the resource table
+	placeResourceTable(resources, *shm + resourceOffset);
 
-	// Gets pointer to message array
-	*messages = (Message *)( ((char*)(*resources)) \
-		     + (sizeof(ResourceDescriptor) * NUM_RESOURCES));
+	// Gets pointer to message array, linked by the resource table's queues
+	*messages = (Message *)(*shm + messageOffset);
+	resources->messages = *messages;
+
+	// Gets pointer to the claim of each simPid on each resource
+	*claims = (uint8_t *)(*shm + claimOffset);
+
+	// Gets pointer to transport channel array, aligned for its atomics
+	*channels = (Channel *)(*shm + channelOffset);
+
+#ifdef TIMER_WAKE
+	// Places the heap of processes sleeping until a simulated time
+	placeTimerWake(*shm + timerOffset, flags & IPC_CREAT);
+#endif
 
 	return shmSize;
 }
-
@@ -12,9 +12,11 @@
 #include "protectedClock.h"
 #include "resourceDescriptor.h"
 #include "sharedMemory.h"
+#include "transport.h"
 
 int getSharedMemoryPointers(char ** shm,  ProtectedClock ** systemClock,
-                            ResourceDescriptor ** resources,
-			    Message ** messages, int flags);
+                            ResourceTable * resources,
+			    Message ** messages, uint8_t ** claims, 
+			    Channel ** channels, int flags);
 
 #endif
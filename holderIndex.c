@@ -0,0 +1,87 @@
+// holderIndex.c was created by Mark Renard on 10/16/2026.
+//
+// This file maintains, for each resource class, one bitmap of processes per
+// possible allocation size. Allocations never exceed MAX_INST, so finding a
+// holder of at least some quantity takes at most MAX_INST bitmap operations.
+
+#include "constants.h"
+#include "dimensions.h"
+#include "holderIndex.h"
+#include "perrorExit.h"
+
+static ProcessMask * holders;	// Holders of each class by amount held
+
+// Returns the bitmap of holders of amount instances of rNum
+static ProcessMask * bucket(int rNum, int amount){
+	return &holders[(rNum * (MAX_INST + 1) + amount) * PROCESS_MASK_WORDS];
+}
+
+// Sets mask to the processes whose flags are nonzero
+void processMask(const int * flags, ProcessMask * mask){
+	int p, w;
+
+	for (w = 0; w < PROCESS_MASK_WORDS; w++)
+		mask[w] = 0;
+
+	for (p = 0; p < MAX_RUNNING; p++)
+		if (flags[p]) mask[p / MASK_BITS] |= 1UL << (p % MASK_BITS);
+}
+
+// Allocates and clears the index
+void initHolderIndex(){
+	holders = allocArray(NUM_RESOURCES * (MAX_INST + 1) 
+			     * PROCESS_MASK_WORDS, sizeof(ProcessMask));
+}
+
+// Records a change in the number of instances of rNum allocated to simPid
+void holderAllocationChanged(int simPid, int rNum, int before, int after){
+	int w = simPid / MASK_BITS;
+	ProcessMask bit = 1UL << (simPid % MASK_BITS);
+
+	if (before < 0 || before > MAX_INST || after < 0 || after > MAX_INST)
+		perrorExit("holderAllocationChanged - allocation out of range");
+
+	// Processes holding no instances are not indexed
+	if (before > 0) bucket(rNum, before)[w] &= ~bit;
+	if (after > 0) bucket(rNum, after)[w] |= bit;
+}
+
+// Returns the lowest simPid in candidates holding at least quantity of rNum,
+// or -1 if there is none
+int holderWithAtLeast(int rNum, int quantity, const ProcessMask * candidates){
+	ProcessMask found;
+	int a, w;
+
+	for (w = 0; w < PROCESS_MASK_WORDS; w++){
+
+		// Every candidate holds at least nothing
+		found = quantity <= 0 ? candidates[w] : 0;
+
+		for (a = quantity > 1 ? quantity : 1; a <= MAX_INST; a++)
+			found |= bucket(rNum, a)[w] & candidates[w];
+
+		if (found != 0) return w * MASK_BITS + __builtin_ctzl(found);
+	}
+
+	return -1;
+}
+
+// Returns the lowest simPid in candidates holding the most of rNum and sets
+// held to the amount held, or returns -1 and sets held to 0 if none hold any
+int greatestHolder(int rNum, const ProcessMask * candidates, int * held){
+	ProcessMask found;
+	int a, w;
+
+	for (a = MAX_INST; a > 0; a--){
+		for (w = 0; w < PROCESS_MASK_WORDS; w++){
+			found = bucket(rNum, a)[w] & candidates[w];
+			if (found != 0){
+				*held = a;
+				return w * MASK_BITS + __builtin_ctzl(found);
+			}
+		}
+	}
+
+	*held = 0;
+	return -1;
+}
@@ -0,0 +1,35 @@
+// holderIndex.h was created by Mark Renard on 10/16/2026.
+//
+// This file contains headers for an index of the processes holding each
+// resource class, bucketed by the number of instances held, so the holders of
+// at least some quantity of a class can be found without scanning every
+// process.
+
+#ifndef HOLDERINDEX_H
+#define HOLDERINDEX_H
+
+#include "constants.h"
+
+#define MASK_BITS (8 * sizeof(ProcessMask))		// Bits per mask word
+#define PROCESS_MASK_WORDS ((MAX_RUNNING + MASK_BITS - 1) / MASK_BITS)
+
+typedef unsigned long ProcessMask;	// Word of a bitmap with a bit per simPid
+
+// Sets mask to the processes whose flags are nonzero
+void processMask(const int * flags, ProcessMask * mask);
+
+// Allocates and clears the index
+void initHolderIndex();
+
+// Records a change in the number of instances of rNum allocated to simPid
+void holderAllocationChanged(int simPid, int rNum, int before, int after);
+
+// Returns the lowest simPid in candidates holding at least quantity of rNum,
+// or -1 if there is none
+int holderWithAtLeast(int rNum, int quantity, const ProcessMask * candidates);
+
+// Returns the lowest simPid in candidates holding the most of rNum and sets
+// held to the amount held, or returns -1 and sets held to 0 if none hold any
+int greatestHolder(int rNum, const ProcessMask * candidates, int * held);
+
+#endif
@@ -2,26 +2,218 @@
 //
 // This file contains definitions for functions that aid in the collection,
 // formatting, and logging of data pertinent to Assignment 5.
+//
+// Each log function encodes its arguments as a LogRecord followed by ints,
+// which writeRecord formats. Built with -DASYNC_LOG, records are copied into a
+// ring that a writer thread drains into the log file in large writes, so oss
+// does no formatting or stdio locking while granting and killing. If the ring
+// is full a record is dropped and counted instead of making oss wait.
 
 #include "clock.h"
 #include "constants.h"
+#include "dimensions.h"
+#include "futex.h"
 #include "perrorExit.h"
 #include "matrixRepresentation.h"
 #include "resourceDescriptor.h"
+#include "rowKernels.h"
 #include "stats.h"
+#include "victimPolicy.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+// Kinds of log record, each formatted by writeRecord
+typedef enum logType {
+	LOG_REQUEST, LOG_ALLOCATION, LOG_ENQUEUE, LOG_TABLE, LOG_RESOURCE_RELEASE,
+	LOG_DETECTION, LOG_DEADLOCKED, LOG_RESOLUTION_ATTEMPT, LOG_KILL,
+	LOG_RESOLUTION_SUCCESS, LOG_COMPLETION, LOG_RELEASE, LOG_MATRICES,
+	LOG_PAD
+} LogType;
+
+// Header of a log record, followed by count ints of arguments
+typedef struct logRecord {
+	LogType type;
+	int count;		// Number of ints following the header
+	Clock time;		// Simulated time, for records that print one
+} LogRecord;
+
+// Rounds the size of a record with count ints up to a multiple of its header's
+// alignment, so the next record in the ring is aligned
+#define RECORD_SZ(count) ((sizeof(LogRecord) + sizeof(int) * (count) \
+	+ _Alignof(LogRecord) - 1) / _Alignof(LogRecord) * _Alignof(LogRecord))
 
 static FILE * log = NULL;
 static int lines = 0;
 
+#ifdef ASYNC_LOG
+static char * ring;			// LOG_RING_SZ bytes of records
+static _Atomic size_t head = 0;		// Bytes of records the writer has read
+static _Atomic size_t tail = 0;		// Bytes of records oss has published
+static size_t reserved = 0;		// End of the record being encoded
+static atomic_uint wakeups = 0;		// Futex word bumped to wake the writer
+static atomic_bool writerIdle = false;	// Writer is waiting for records
+static atomic_bool stopping = false;	// Writer should drain and exit
+static bool writerRunning = false;	// Writer thread has not been joined
+static pthread_t writer;		// Thread writing records to the log
+#else
+static LogRecord * scratch;		// Record being encoded, written at once
+#endif
+
+static void writeRecord(FILE * fp, const LogRecord * record);
+
+#ifdef ASYNC_LOG
+
+// Waits until oss publishes records past offset h or asks the writer to stop
+static void waitForRecords(size_t h){
+	unsigned int seen = atomic_load(&wakeups);
+
+	// Rechecks after announcing the wait so a publish cannot be missed
+	atomic_store(&writerIdle, true);
+	if (atomic_load(&tail) == h && !atomic_load(&stopping))
+		futexWait(&wakeups, seen);
+	atomic_store(&writerIdle, false);
+}
+
+// Formats records from the ring into the log file until asked to stop
+static void * runLogWriter(void * arg){
+	size_t h = atomic_load_explicit(&head, memory_order_relaxed);
+	size_t offset;
+	const LogRecord * record;
+
+	while (true){
+		if (h == atomic_load_explicit(&tail, memory_order_acquire)){
+			if (atomic_load(&stopping)) break;
+			waitForRecords(h);
+			continue;
+		}
+
+		// Skips to the start of the ring past any padding at its end
+		offset = h % LOG_RING_SZ;
+		record = (const LogRecord *)(ring + offset);
+		if (LOG_RING_SZ - offset < sizeof(LogRecord) 
+		    || record->type == LOG_PAD){
+			h += LOG_RING_SZ - offset;
+		} else {
+			writeRecord(log, record);
+			h += RECORD_SZ(record->count);
+		}
+
+		// Frees the space of the record for oss
+		atomic_store_explicit(&head, h, memory_order_release);
+	}
+
+	return NULL;
+}
+
+// Writes every published record and joins the writer thread if it is running
+static void stopLogWriter(){
+	if (!writerRunning) return;
+	writerRunning = false;
+
+	atomic_store(&stopping, true);
+	atomic_fetch_add(&wakeups, 1);
+	futexWakeOne(&wakeups);
+
+	if ((errno = pthread_join(writer, NULL)) != 0)
+		perrorExit("logging.c - failed to join log writer");
+}
+
+#endif
+
+// Returns space for a record with count ints of arguments, or NULL if the
+// record is dropped because the ring is full
+static LogRecord * beginRecord(LogType type, int count, Clock time){
+	LogRecord * record;
+
+#ifdef ASYNC_LOG
+	size_t size = RECORD_SZ(count);
+	size_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+	size_t offset = t % LOG_RING_SZ;
+	size_t pad = offset + size > LOG_RING_SZ ? LOG_RING_SZ - offset : 0;
+
+	// Drops the record if it and any padding do not fit in free space
+	if (t + pad + size 
+	    - atomic_load_explicit(&head, memory_order_acquire) > LOG_RING_SZ){
+		statsLogRecordDropped();
+		return NULL;
+	}
+
+	// Marks the rest of the ring as padding if the record does not fit
+	if (pad >= sizeof(LogRecord))
+		((LogRecord *)(ring + offset))->type = LOG_PAD;
+
+	record = (LogRecord *)(ring + (t + pad) % LOG_RING_SZ);
+	reserved = t + pad + size;
+#else
+	record = scratch;
+#endif
+
+	record->type = type;
+	record->count = count;
+	record->time = time;
+	return record;
+}
+
+// Publishes a record to the writer, or writes it at once without ASYNC_LOG
+static void commitRecord(LogRecord * record){
+#ifdef ASYNC_LOG
+	atomic_store(&tail, reserved);
+
+	// Wakes an idle writer once enough is queued to write in one batch
+	if (reserved - atomic_load_explicit(&head, memory_order_relaxed) 
+	    >= LOG_WAKE_SZ && atomic_exchange(&writerIdle, false)){
+		atomic_fetch_add(&wakeups, 1);
+		futexWakeOne(&wakeups);
+	}
+#else
+	writeRecord(log, record);
+#endif
+}
+
+// Returns the arguments following a record's header
+static int * recordArgs(const LogRecord * record){
+	return (int *)(record + 1);
+}
+
 // Opens the log file with name LOG_FILE_NAME or exits with an error message
 void openLogFile(){
 	if ((log = fopen(LOG_FILE_NAME, "w+")) == NULL)
 		perrorExit("logging.c - failed to open log file");
+
+#ifdef ASYNC_LOG
+	// Buffers enough of the file that the writer makes few large writes
+	if (setvbuf(log, NULL, _IOFBF, LOG_BATCH_SZ) != 0)
+		perrorExit("logging.c - failed to buffer log file");
+
+	ring = allocArray(LOG_RING_SZ, sizeof(char));
+
+	// Starts the writer with signals blocked so oss's handlers run in oss
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+
+	if ((errno = pthread_create(&writer, NULL, runLogWriter, NULL)) != 0)
+		perrorExit("logging.c - failed to start log writer");
+	writerRunning = true;
+
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+#else
+	// Makes room for the largest record, a matrix representation
+	scratch = allocArray(1, RECORD_SZ(NUM_RESOURCES * (2 * MAX_RUNNING + 1)));
+#endif
 }
 
 // Closes the log file
 void closeLogFile(){
+#ifdef ASYNC_LOG
+	stopLogWriter();
+#endif
+
 	if (log != NULL){
 		if (fclose(log) == -1)
 			perrorExit("logging.c - error closing log file");
@@ -33,10 +225,14 @@ void logRequestDetection(int simPid, int resourceId, int count, Clock time){
 #ifdef VERBOSE
 	if (++lines > MAX_LOG_LINES) return;
 
+	LogRecord * record = beginRecord(LOG_REQUEST, 3, time);
+	if (record == NULL) return;
 
-	fprintf(log, "Master has detected Process P%d requesting %d of R%d at" \
-		" time %03d : %09d\n", simPid, count, resourceId, 
-		time.seconds, time.nanoseconds);
+	int * args = recordArgs(record);
+	args[0] = simPid;
+	args[1] = count;
+	args[2] = resourceId;
+	commitRecord(record);
 #endif
 }
 
@@ -47,10 +243,14 @@ void logAllocation(int simPid, int resourceId, int count, Clock time){
 #ifdef VERBOSE
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "Master granted P%d request for %d of R%d at time " \
-		" %03d : %09d\n", simPid, count, resourceId, time.seconds, 
-		time.nanoseconds);
+	LogRecord * record = beginRecord(LOG_ALLOCATION, 3, time);
+	if (record == NULL) return;
 
+	int * args = recordArgs(record);
+	args[0] = simPid;
+	args[1] = count;
+	args[2] = resourceId;
+	commitRecord(record);
 #endif
 }
 
@@ -59,13 +259,20 @@ void logEnqueue(int simPid, int quantity, int rNum, int available){
 #ifdef VERBOSE
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "\tP%d requested %d of R%d but only %d available, " \
-		"enqueueing request\n", simPid, quantity, rNum, available);
+	LogRecord * record = beginRecord(LOG_ENQUEUE, 4, zeroClock());
+	if (record == NULL) return;
+
+	int * args = recordArgs(record);
+	args[0] = simPid;
+	args[1] = quantity;
+	args[2] = rNum;
+	args[3] = available;
+	commitRecord(record);
 #endif
 }
 
 // Prints the resource allocation table every 20 requests by default
-void logTable(const ResourceDescriptor * resources){
+void logTable(const ResourceTable * resources){
 #ifdef VERBOSE
 	if (lines >= MAX_LOG_LINES) return;
 	static int callCount = 0;	// Times called since last print
@@ -75,34 +282,20 @@ void logTable(const ResourceDescriptor * resources){
 	if (callCount < ALLOC_PER_TABLE) return;
 	callCount = 0;
 
-	// Prints the table	
-	int m, n;	// m resources, n processes
-	
-	// Prints header
-	fprintf(log, "\n     ");
-	lines++;
-
-	for (m = 0; m < NUM_RESOURCES; m++){
-		fprintf(log, "R%02d ", m);
-	}
+	// Counts a header, a row per process, and two blank lines
+	lines += MAX_RUNNING + 3;
 
-	fprintf(log, "\n");
-	lines++;
-
-	// Prints rows
-	for (n = 0; n < MAX_RUNNING; n++){
-		fprintf(log, "P%02d: ", n);
-
-		// Prints each resource
-		for (m = 0; m < NUM_RESOURCES; m++)
-			fprintf(log, "%02d  ", resources[m].allocations[n]);
+	// Copies the allocations so the table shows them as of this call
+	LogRecord * record = beginRecord(LOG_TABLE, MAX_RUNNING * NUM_RESOURCES,
+					 zeroClock());
+	if (record == NULL) return;
 
-		fprintf(log, "\n");
-		lines++;
-	}
+	int * args = recordArgs(record);
+	int i;
+	for (i = 0; i < MAX_RUNNING * NUM_RESOURCES; i++)
+		args[i] = resources->allocations[i];
 
-	fprintf(log, "\n");
-	lines++;
+	commitRecord(record);
 #endif
 }
 
@@ -111,9 +304,14 @@ void logResourceRelease(int simPid, int resourceId, int count, Clock time){
 #ifdef VERBOSE
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "Master has acknowledged Process P%d releasing %d of R%d" \
-		" at time %03d : %09d\n", simPid, count, resourceId, 
-		time.seconds, time.nanoseconds);
+	LogRecord * record = beginRecord(LOG_RESOURCE_RELEASE, 3, time);
+	if (record == NULL) return;
+
+	int * args = recordArgs(record);
+	args[0] = simPid;
+	args[1] = count;
+	args[2] = resourceId;
+	commitRecord(record);
 #endif
 }
 
@@ -123,30 +321,32 @@ void logDeadlockDetection(Clock time){
 
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "Master running deadlock detection at time %03d : %09d:" \
-		"\n", time.seconds, time.nanoseconds);
-
+	LogRecord * record = beginRecord(LOG_DETECTION, 0, time);
+	if (record != NULL) commitRecord(record);
 }
 
 // Prints the pids of processes in deadlock
 void logDeadlockedProcesses(int * deadlockedPids, int size){
 	if (++lines > MAX_LOG_LINES || size < 1) return;
 
-	fprintf(log, "\tProcesses P%d", deadlockedPids[0]);
+	LogRecord * record = beginRecord(LOG_DEADLOCKED, size, zeroClock());
+	if (record == NULL) return;
 
-	int i = 1;
-	for ( ; i < size; i++){
-		fprintf(log, ", P%d", deadlockedPids[i]);
-	}
+	int * args = recordArgs(record);
+	int i;
+	for (i = 0; i < size; i++)
+		args[i] = deadlockedPids[i];
 
-	fprintf(log, " deadlocked\n");
+	commitRecord(record);
 }
 
 // Prints that a deadlock resolution attempt is being made
 void logResolutionAttempt(){
 	// Prints resolution to log file if 
 	if (++lines > MAX_LOG_LINES) return;
-	fprintf(log, "\tAttempting to resolve deadlock...\n");
+
+	LogRecord * record = beginRecord(LOG_RESOLUTION_ATTEMPT, 0, zeroClock());
+	if (record != NULL) commitRecord(record);
 }
 
 // Prints a message indicating that a process with logical pid was killed
@@ -155,7 +355,11 @@ void logKill(int simPid){
 
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "\tKilling process P%d\n", simPid);
+	LogRecord * record = beginRecord(LOG_KILL, 1, zeroClock());
+	if (record == NULL) return;
+
+	recordArgs(record)[0] = simPid;
+	commitRecord(record);
 }
 
 // Prints a message indicating that deadlock has been resolved
@@ -164,7 +368,8 @@ void logResolutionSuccess(int killed, int runningAtStart){
 
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "\tSystem is no longer deadlocked.\n");
+	LogRecord * record = beginRecord(LOG_RESOLUTION_SUCCESS, 0, zeroClock());
+	if (record != NULL) commitRecord(record);
 }
 
 // Prints a message indicating that a process has terminated on its own
@@ -174,7 +379,11 @@ void logCompletion(int simPid){
 #ifdef VERBOSE
 	if (++lines > MAX_LOG_LINES) return;
 
-	fprintf(log, "\tMaster has responded to P%d completing\n", simPid);
+	LogRecord * record = beginRecord(LOG_COMPLETION, 1, zeroClock());
+	if (record == NULL) return;
+
+	recordArgs(record)[0] = simPid;
+	commitRecord(record);
 #endif
 }
 
@@ -199,15 +408,17 @@ void logRelease(int * resources){
 	// Returns if max log lines reached	
 	if (++lines > MAX_LOG_LINES) return;
 
-	// Prints message, first resource released and quantity
-	fprintf(log, "\t\tResources released are as follows: R%d:%d",
-		indices[0], released[0]);
+	// Records each resource released and its quantity as a pair
+	LogRecord * record = beginRecord(LOG_RELEASE, 2 * j, zeroClock());
+	if (record == NULL) return;
 
-	// Prints subsequent resources released and quantity
-	for (i = 1; i < j; i++){
-		fprintf(log, ", R%d:%d", indices[i], released[i]);
+	int * args = recordArgs(record);
+	for (i = 0; i < j; i++){
+		args[2 * i] = indices[i];
+		args[2 * i + 1] = released[i];
 	}
-	fprintf(log, "\n");
+
+	commitRecord(record);
 }
 
 // Prints table of m resources, n processes
@@ -261,10 +472,14 @@ int printMatrices(FILE * fp, const int * allocated, const int * request,
 }
 
 // Prints a matrix representation of the state of the program to a file
-int printMatrixRep(FILE * fp, const ResourceDescriptor * resources){
-        int allocated[NUM_RESOURCES * MAX_RUNNING];     // Resource allocation
-        int request[NUM_RESOURCES * MAX_RUNNING];       // Current requests
+int printMatrixRep(FILE * fp, const ResourceTable * resources){
+        int * allocated;                                // Resource allocation
+        int * request;                                  // Current requests
         int available[NUM_RESOURCES];                   // Available resources
+        int addedLines;
+
+        allocated = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+        request = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
 
         // Initializes vectors
         setAllocated(resources, allocated);
@@ -272,14 +487,31 @@ int printMatrixRep(FILE * fp, const ResourceDescriptor * resources){
         setAvailable(resources, available);
 
 	// Prints matrices
-	return printMatrices(fp, allocated, request, available);
+	addedLines = printMatrices(fp, allocated, request, available);
+
+	free(allocated);
+	free(request);
+	return addedLines;
 }
 
 // Logs a matrix representation of the system state
-void logMatrixRep(const ResourceDescriptor * resources){
+void logMatrixRep(const ResourceTable * resources){
 	if (lines > MAX_LOG_LINES) return;
 
-	lines += printMatrixRep(log, resources);
+	// Counts the lines printMatrices adds for the three tables
+	lines += 6 + 2 * (MAX_RUNNING + 2) + 3;
+
+	LogRecord * record = beginRecord(LOG_MATRICES, 
+		NUM_RESOURCES * (2 * MAX_RUNNING + 1), zeroClock());
+	if (record == NULL) return;
+
+	// Builds the matrices directly in the record
+	int * args = recordArgs(record);
+	setAllocated(resources, args);
+	setRequest(resources, args + NUM_RESOURCES * MAX_RUNNING);
+	setAvailable(resources, args + 2 * NUM_RESOURCES * MAX_RUNNING);
+
+	commitRecord(record);
 }
 
 // Logs allocated, requested, and available matrices
@@ -287,23 +519,155 @@ void logMatrices(const int * allocated, const int * request,
 		 const int * available){
 	if (lines > MAX_LOG_LINES) return;
 
-	lines += printMatrices(log, allocated, request, available);
+	// Counts the lines printMatrices adds for the three tables
+	lines += 6 + 2 * (MAX_RUNNING + 2) + 3;
+
+	LogRecord * record = beginRecord(LOG_MATRICES, 
+		NUM_RESOURCES * (2 * MAX_RUNNING + 1), zeroClock());
+	if (record == NULL) return;
+
+	// Copies each matrix into the record
+	int * args = recordArgs(record);
+	int i;
+	for (i = 0; i < NUM_RESOURCES * MAX_RUNNING; i++){
+		args[i] = allocated[i];
+		args[NUM_RESOURCES * MAX_RUNNING + i] = request[i];
+	}
+	for (i = 0; i < NUM_RESOURCES; i++)
+		args[2 * NUM_RESOURCES * MAX_RUNNING + i] = available[i];
+
+	commitRecord(record);
+}
+
+// Formats a log record to a file
+static void writeRecord(FILE * fp, const LogRecord * record){
+	const int * args = recordArgs(record);
+	Clock time = record->time;
+	int i, m, n;
+
+	switch (record->type){
+	case LOG_REQUEST:
+		fprintf(fp, "Master has detected Process P%d requesting %d of "\
+			"R%d at time %03d : %09d\n", args[0], args[1], args[2],
+			clockSeconds(time), clockNanoseconds(time));
+		break;
+
+	case LOG_ALLOCATION:
+		fprintf(fp, "Master granted P%d request for %d of R%d at time " \
+			" %03d : %09d\n", args[0], args[1], args[2], 
+			clockSeconds(time), clockNanoseconds(time));
+		break;
+
+	case LOG_ENQUEUE:
+		fprintf(fp, "\tP%d requested %d of R%d but only %d available, " \
+			"enqueueing request\n", args[0], args[1], args[2], 
+			args[3]);
+		break;
+
+	case LOG_TABLE:
+		// Prints header
+		fprintf(fp, "\n     ");
+		for (m = 0; m < NUM_RESOURCES; m++)
+			fprintf(fp, "R%02d ", m);
+		fprintf(fp, "\n");
+
+		// Prints rows
+		for (n = 0; n < MAX_RUNNING; n++){
+			fprintf(fp, "P%02d: ", n);
+			for (m = 0; m < NUM_RESOURCES; m++)
+				fprintf(fp, "%02d  ", args[n*NUM_RESOURCES + m]);
+			fprintf(fp, "\n");
+		}
 
+		fprintf(fp, "\n");
+		break;
+
+	case LOG_RESOURCE_RELEASE:
+		fprintf(fp, "Master has acknowledged Process P%d releasing %d " \
+			"of R%d at time %03d : %09d\n", args[0], args[1], 
+			args[2], clockSeconds(time), clockNanoseconds(time));
+		break;
+
+	case LOG_DETECTION:
+		fprintf(fp, "Master running deadlock detection at time " \
+			"%03d : %09d:\n", clockSeconds(time), 
+			clockNanoseconds(time));
+		break;
+
+	case LOG_DEADLOCKED:
+		fprintf(fp, "\tProcesses P%d", args[0]);
+		for (i = 1; i < record->count; i++)
+			fprintf(fp, ", P%d", args[i]);
+		fprintf(fp, " deadlocked\n");
+		break;
+
+	case LOG_RESOLUTION_ATTEMPT:
+		fprintf(fp, "\tAttempting to resolve deadlock...\n");
+		break;
+
+	case LOG_KILL:
+		fprintf(fp, "\tKilling process P%d\n", args[0]);
+		break;
+
+	case LOG_RESOLUTION_SUCCESS:
+		fprintf(fp, "\tSystem is no longer deadlocked.\n");
+		break;
+
+	case LOG_COMPLETION:
+		fprintf(fp, "\tMaster has responded to P%d completing\n", 
+			args[0]);
+		break;
+
+	case LOG_RELEASE:
+		fprintf(fp, "\t\tResources released are as follows: R%d:%d",
+			args[0], args[1]);
+		for (i = 2; i < record->count; i += 2)
+			fprintf(fp, ", R%d:%d", args[i], args[i + 1]);
+		fprintf(fp, "\n");
+		break;
+
+	case LOG_MATRICES:
+		printMatrices(fp, args, args + NUM_RESOURCES * MAX_RUNNING,
+			      args + 2 * NUM_RESOURCES * MAX_RUNNING);
+		break;
+
+	case LOG_PAD:
+		break;
+	}
 }
 
 // Prints statistics to the log file at the end of a run
 void logStats(){
 	Stats stats = getStats();
 
+#ifdef ASYNC_LOG
+	// Writes every queued record before the statistics
+	stopLogWriter();
+#endif
+
 	fprintf(log, "\nSTATS:\n" \
 		"Total requests granted: %lu\n" \
 		"Processes terminated by deadlock detection/recovery: %lu\n" \
 		"Processes terminated successfully: %lu\n" \
-		"Times deadlock detection run: %lu\n\n" \
+		"Times deadlock detection run: %lu\n" \
+		"Detection passes using the wait-for graph: %lu\n" \
+		"Detection passes skipped as unchanged: %lu\n" \
+		"Grants refused as unsafe by deadlock avoidance: %lu\n" \
+		"Pooled worker processes launched: %lu\n" \
+		"Log records dropped on ring overflow: %lu\n" \
+		"Deadlock detection kernels: %s\n" \
+		"Victim selection policy: %s\n\n" \
 		"%f percent of processes terminated per deadlock on average.",
 		stats.numRequestsGranted,
 		stats.numProcessesKilled,
 		stats.numProcessesCompleted,
 		stats.numTimesDeadlockDetectionRun,
+		stats.numTimesGraphDetectionRun,
+		stats.numTimesDeadlockDetectionSkipped,
+		stats.numUnsafeGrantsRefused,
+		stats.numWorkersLaunched,
+		stats.numLogRecordsDropped,
+		rowKernelName(),
+		victimPolicyName(),
 		stats.percentKilledPerDeadlock);
 }
@@ -24,7 +24,7 @@ void logAllocation(int simPid, int resourceId, int count, Clock time);
 void logEnqueue(int simPid, int quantity, int rNum, int available);
 
 // Prints the resource allocation table every 20 requests by default
-void logTable(ResourceDescriptor * resources);
+void logTable(const ResourceTable * resources);
 
 // Logs the ids and quantities of resources being released at a particular time
 void logResourceRelease(int simPid, int resourceId, int count, Clock time);
@@ -58,10 +58,10 @@ int printMatrices(FILE * fp, const int * allocated, const int * requested,
 		  const int * available); 
 
 // Prints a matrix representation of the state of the program to a file
-int printMatrixRep(FILE * fp, const ResourceDescriptor * resources);
+int printMatrixRep(FILE * fp, const ResourceTable * resources);
 
 // Logs a matrix representation of the system state
-void logMatrixRep(const ResourceDescriptor * resources);
+void logMatrixRep(const ResourceTable * resources);
 
 // Logs allocated, requested, and available matrices
 void logMatrices(const int * allocated, const int * requested,
@@ -1,31 +1,43 @@
 // matrixRepresentation.c was created by Mark Renard on 4/15/2020.
 //
 // These functions return matrix representations of the state of the system.
+// oss also keeps live copies of the matrices, updated as requests are granted,
+// enqueued and released, so deadlock detection does not rebuild them. The
+// same updates maintain the wait-for graph in waitForGraph.c, the index of
+// holders in holderIndex.c, and the remaining need of each process's claim.
 
 #include "resourceDescriptor.h"
 #include "constants.h"
+#include "dimensions.h"
+#include "holderIndex.h"
+#include "waitForGraph.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+static int * allocatedMatrix;			// Live allocation
+static int * requestMatrix;			// Live requests
+static int * availableVector;			// Live available
+static int * needMatrix;			// Claim - allocation
+static unsigned long version = 0;			// Count of changes
+static unsigned long releases = 0;		// Count of releases and claims
 
 // Sets the allocation matrix
-void setAllocated(const ResourceDescriptor * resources,
+void setAllocated(const ResourceTable * resources,
                           int * allocated){
-        int m = NUM_RESOURCES;
-
-        int r, p;
-        for (p = 0; p < MAX_RUNNING; p++) {
-                for (r = 0; r < NUM_RESOURCES; r++){
-                        allocated[p*m + r] = resources[r].allocations[p];
-                }
-        }
+        int i;
+        for (i = 0; i < NUM_RESOURCES * MAX_RUNNING; i++)
+                allocated[i] = resources->allocations[i];
 }
 
 // Sets the request matrix
-void setRequest(const ResourceDescriptor * resources,
+void setRequest(const ResourceTable * resources,
                         int * request){
         int i, r, p;
         int m = NUM_RESOURCES;
         int n = MAX_RUNNING;
 
-        Message * msg;
+        int q;
 
         // Initializes values to 0
         for (i = 0; i < m * n; i++){
@@ -34,23 +46,150 @@ void setRequest(const ResourceDescriptor * resources,
 
         // Sums requests in waiting queue of each resource descriptor
         for (r = 0; r < NUM_RESOURCES; r++){
-                msg = resources[r].waiting.front;
+                q = resources->waiting[r].front;
 
-                while (msg != NULL){
-                        p = msg->simPid;
-                        request[p*m + r] += msg->quantity;
-                        msg = msg->previous;
+                while (q != NO_MSG){
+                        p = resources->messages[q].simPid;
+                        request[p*m + r] += resources->messages[q].quantity;
+                        q = resources->messages[q].previous;
                 }
         }
 
 }
 
 // Sets the available vector
-void setAvailable(const ResourceDescriptor * resources,
+void setAvailable(const ResourceTable * resources,
                          int * available) {
         int r;
         for (r = 0; r < NUM_RESOURCES; r++){
-                available[r] = resources[r].numAvailable;
+                available[r] = resources->numAvailable[r];
         }
 }
 
+
+// Initializes the live matrices from a newly initialized resource table
+void initLiveMatrices(const ResourceTable * resources){
+        allocatedMatrix = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+        requestMatrix = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+        availableVector = allocArray(NUM_RESOURCES, sizeof(int));
+        needMatrix = allocArray(NUM_RESOURCES * MAX_RUNNING, sizeof(int));
+
+        setAllocated(resources, allocatedMatrix);
+        setRequest(resources, requestMatrix);
+        setAvailable(resources, availableVector);
+        initWaitForGraph(resources);
+        initHolderIndex();
+}
+
+// Records that quantity of rNum was allocated to simPid
+void recordGrant(int simPid, int rNum, int quantity, bool shareable){
+        int * allocation = &allocatedMatrix[simPid*NUM_RESOURCES + rNum];
+
+        graphAllocationChanged(simPid, rNum, *allocation, 
+                               *allocation + quantity);
+        holderAllocationChanged(simPid, rNum, *allocation, 
+                                *allocation + quantity);
+        *allocation += quantity;
+        needMatrix[simPid*NUM_RESOURCES + rNum] -= quantity;
+        if (!shareable) availableVector[rNum] -= quantity;
+        version++;
+}
+
+// Records that simPid released quantity of rNum
+void recordRelease(int simPid, int rNum, int quantity, bool shareable){
+        int * allocation = &allocatedMatrix[simPid*NUM_RESOURCES + rNum];
+
+        graphAllocationChanged(simPid, rNum, *allocation, 
+                               *allocation - quantity);
+        holderAllocationChanged(simPid, rNum, *allocation, 
+                                *allocation - quantity);
+        *allocation -= quantity;
+        needMatrix[simPid*NUM_RESOURCES + rNum] += quantity;
+        if (!shareable) availableVector[rNum] += quantity;
+        version++;
+        releases++;
+}
+
+// Records that a request by simPid was added to the waiting queue of rNum
+void recordEnqueue(int simPid, int rNum, int quantity){
+        requestMatrix[simPid*NUM_RESOURCES + rNum] += quantity;
+        graphWaitChanged(simPid, rNum, true);
+        version++;
+}
+
+// Records that a request by simPid left the waiting queue of rNum
+void recordDequeue(int simPid, int rNum, int quantity){
+        requestMatrix[simPid*NUM_RESOURCES + rNum] -= quantity;
+        graphWaitChanged(simPid, rNum, false);
+        version++;
+}
+
+// Records the maximum claim of simPid on each resource
+void recordClaim(int simPid, const uint8_t * claim){
+        int r, i;
+        for (r = 0; r < NUM_RESOURCES; r++){
+                i = simPid*NUM_RESOURCES + r;
+                needMatrix[i] = claim[r] - allocatedMatrix[i];
+        }
+        version++;
+        releases++;
+}
+
+// Returns a number that changes whenever the live matrices change
+unsigned long stateVersion(){
+        return version;
+}
+
+// Returns a number that changes whenever resources are released or a claim
+// is recorded
+unsigned long releaseVersion(){
+        return releases;
+}
+
+// Returns the live allocation matrix
+const int * liveAllocated(){
+        return allocatedMatrix;
+}
+
+// Returns the live request matrix
+const int * liveRequest(){
+        return requestMatrix;
+}
+
+// Returns the live available vector
+const int * liveAvailable(){
+        return availableVector;
+}
+
+// Returns the live need matrix
+const int * liveNeed(){
+        return needMatrix;
+}
+
+// Returns true if the live matrices match ones rebuilt from the resource table
+bool liveMatricesMatch(const ResourceTable * resources){
+        int * rebuiltAllocated = allocArray(NUM_RESOURCES * MAX_RUNNING,
+                                            sizeof(int));
+        int * rebuiltRequest = allocArray(NUM_RESOURCES * MAX_RUNNING,
+                                          sizeof(int));
+        int rebuiltAvailable[NUM_RESOURCES];
+        bool match = true;
+        int i;
+
+        setAllocated(resources, rebuiltAllocated);
+        setRequest(resources, rebuiltRequest);
+        setAvailable(resources, rebuiltAvailable);
+
+        for (i = 0; i < NUM_RESOURCES * MAX_RUNNING; i++){
+                if (rebuiltAllocated[i] != allocatedMatrix[i]) match = false;
+                if (rebuiltRequest[i] != requestMatrix[i]) match = false;
+        }
+
+        for (i = 0; i < NUM_RESOURCES; i++){
+                if (rebuiltAvailable[i] != availableVector[i]) match = false;
+        }
+
+        free(rebuiltAllocated);
+        free(rebuiltRequest);
+        return match;
+}
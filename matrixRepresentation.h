@@ -5,15 +5,51 @@
 #ifndef MATRIXREPRESENTATION_H
 #define MATRIXREPRESENTATION_H
 
+#include <stdbool.h>
 #include "resourceDescriptor.h"
 
 // Sets the allocation matrix
-void setAllocated(const ResourceDescriptor * resources, int * allocated);
+void setAllocated(const ResourceTable * resources, int * allocated);
 
 // Sets the request matrix
-void setRequest(const ResourceDescriptor * resources, int * request);
+void setRequest(const ResourceTable * resources, int * request);
 
 // Sets the available vector
-void setAvailable(const ResourceDescriptor * resources, int * available);
+void setAvailable(const ResourceTable * resources, int * available);
+
+// Initializes the live matrices from a newly initialized resource table
+void initLiveMatrices(const ResourceTable * resources);
+
+// Records that quantity of rNum was allocated to simPid
+void recordGrant(int simPid, int rNum, int quantity, bool shareable);
+
+// Records that simPid released quantity of rNum
+void recordRelease(int simPid, int rNum, int quantity, bool shareable);
+
+// Records that a request by simPid was added to the waiting queue of rNum
+void recordEnqueue(int simPid, int rNum, int quantity);
+
+// Records that a request by simPid left the waiting queue of rNum
+void recordDequeue(int simPid, int rNum, int quantity);
+
+// Records the maximum claim of simPid on each resource
+void recordClaim(int simPid, const uint8_t * claim);
+
+// Returns a number that changes whenever the live matrices change
+unsigned long stateVersion();
+
+// Returns a number that changes whenever resources are released or a claim
+// is recorded
+unsigned long releaseVersion();
+
+// Return the live allocation matrix, request matrix, available vector, and
+// need matrix (the claims recorded less allocations)
+const int * liveAllocated();
+const int * liveRequest();
+const int * liveAvailable();
+const int * liveNeed();
+
+// Returns true if the live matrices match ones rebuilt from the resource table
+bool liveMatricesMatch(const ResourceTable * resources);
 
 #endif
@@ -6,6 +6,7 @@
 #include "constants.h"
 #include "queue.h"
 #include "message.h"
+#include "perrorExit.h"
 
 #include <stdio.h>
 
@@ -13,10 +14,7 @@
 static void zeroFields(Message * msg){
 	msg->type = VOID;
 	msg->quantity = 0;
-
-	int i = 0;
-	for( ; i < NUM_RESOURCES; i++)
-		msg->target[i] = 0;
+	msg->seq = 0;
 	msg->numClassesHeld = 0;
 }
 
@@ -30,9 +28,9 @@ void initMessage(Message * msg, int simPid){
 	zeroFields(msg);
 
 	// Initializes queue values
-	msg->currentQueue = NULL;
-	msg->next = NULL;
-	msg->previous = NULL;
+	msg->currentQueue = NO_QUEUE;
+	msg->next = NO_MSG;
+	msg->previous = NO_MSG;
 }
 
 // Initializes the shared array of messages to default values
@@ -46,7 +44,8 @@ void initMessageArray(Message * msgArr){
 	}
 }
 
-// Returns a message to its state before it was assigned to a process
+// Returns a message to its state before it was assigned to a process. The
+// message must already have been removed from any queue.
 void resetMessage(Message * msg){
 /*	msg->type = VOID;
 	msg->quantity = 0;
@@ -56,8 +55,8 @@ void resetMessage(Message * msg){
 		msg->target[i] = 0;
 	msg->numClassesHeld = 0;
 */
-	zeroFields(msg);
+	if (msg->currentQueue != NO_QUEUE)
+		perrorExit("resetMessage on msg still in a queue");
 
-	if (msg->currentQueue != NULL)
-		removeFromCurrentQueue(msg);
+	zeroFields(msg);
 }
@@ -6,28 +6,27 @@
 #define MESSAGE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "constants.h"
 
 typedef enum msgType {
 	VOID, TERMINATION, REQUEST, PENDING_REQUEST, RELEASE
 } MsgType;
 
-struct queue;
-
 typedef struct message{
 	int simPid;			// The simPid of the sender
 	
 	int type;			// The type of the message
 	int rNum;			// The id of the resource, if applicable
 	int quantity;			// The quantity of the resource requested
+	unsigned int seq;		// Sequence number of the last message
 
-	int target[NUM_RESOURCES]; 	// Target number of each resource
 	int numClassesHeld;	 	// Number of resource classes held
 
-	// Attributes used in Queue
-	struct queue * currentQueue;		// Queue the message is currently in
-	struct message * next;		// Next message in current queue
-	struct message * previous;	// Previous message in queue
+	// Attributes used in Queue, indices rather than pointers
+	int16_t currentQueue;		// Index of the queue the message is in
+	int16_t next;			// simPid of next message in queue
+	int16_t previous;		// simPid of previous message in queue
 
 } Message;
 
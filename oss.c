@@ -3,7 +3,10 @@
 // This program simulates deadlock detection and resolution.
 
 #include "clock.h"
+#include "coroutine.h"
 #include "deadlockDetection.h"
+#include "dimensions.h"
+#include "eventQueue.h"
 #include "getSharedMemoryPointers.h"
 #include "logging.h"
 #include "message.h"
@@ -13,11 +16,18 @@
 #include "protectedClock.h"
 #include "qMsg.h"
 #include "queue.h"
+#include "randomGen.h"
 #include "resourceDescriptor.h"
+#include "resourceSet.h"
 #include "stats.h"
+#include "timerWake.h"
+#include "transport.h"
+#include "userProcess.h"
+#include "victimPolicy.h"
 
 #include <errno.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <signal.h>
 #include <stdbool.h>
@@ -28,20 +38,55 @@
 #include <time.h>
 #include <unistd.h>
 
+#if defined(THREADED_USERS) && !(defined(SHM_RING) && defined(FUTEX_REPLY))
+#error "THREADED_USERS requires SHM_RING and FUTEX_REPLY"
+#endif
+#if defined(COROUTINE_USERS) && !defined(SHM_RING)
+#error "COROUTINE_USERS requires SHM_RING"
+#endif
+#if defined(THREADED_USERS) + defined(COROUTINE_USERS) \
+    + defined(WORKER_POOL) > 1
+#error "THREADED_USERS, COROUTINE_USERS and WORKER_POOL cannot be combined"
+#endif
+#if defined(THREADED_USERS) || defined(COROUTINE_USERS)
+#define IN_PROCESS_USERS	// User processes are simulated inside oss
+#endif
+
 // Prototypes
+static void parseArguments(int argc, char * argv[]);
+static void usageExit();
 static void simulateResourceManagement();
+static void launchIfAble();
+static void respondToMessage(int m);
+static void detectAndResolveDeadlock();
 static pid_t launchUserProcess(int simPid);
+#ifdef WORKER_POOL
+static pid_t assignWorker(int simPid);
+static void stopWorkers();
+#endif
 static int parseMessage();
+static void sendReply(int simPid, Opcode opcode);
 void killProcess(int simPid, pid_t realPid);
 static void processTermination(int simPid, pid_t realPid);
 static void finalizeTermination(int * released, int simPid, pid_t realPid);
 static void releaseResources(int * released, int simPid);
+#ifndef IN_PROCESS_USERS
 static void waitForProcess(pid_t realPid);
+#endif
+#ifdef THREADED_USERS
+static void * runUserThread(void * user);
+#endif
+#ifdef COROUTINE_USERS
+static void runUserCoroutine(void * user);
+static void suspendUserCoroutine(UserProcess * user, const Clock * until);
+#endif
 static void processRequest(int simPid);
 static void processRelease(int);
 static void processQueuedRequests(int rNum);
-static void processAllQueuedRequests();
-static void processReleasedResourceQueues(int * released);
+static bool grantable(Message * msg);
+static void updateGrantable(int rNum);
+static void processDirtyResourceQueues();
+static void endMessageBatch();
 static void grantRequest(Message * msg);
 static void validateState(char * functionName);
 static void assignSignalHandlers();
@@ -49,26 +94,57 @@ static void cleanUpAndExit(int param);
 static void cleanUp();
 
 // Constants
-static const Clock DETECTION_INTERVAL = {DETECTION_INTERVAL_SEC, 
-					 DETECTION_INTERVAL_NS};
-static const Clock MIN_FORK_TIME = {MIN_FORK_TIME_SEC, MIN_FORK_TIME_NS};
-static const Clock MAX_FORK_TIME = {MAX_FORK_TIME_SEC, MAX_FORK_TIME_NS};
-static const Clock MAIN_LOOP_INCREMENT = {LOOP_INCREMENT_SEC,
-					  LOOP_INCREMENT_NS};
+static const Clock DETECTION_INTERVAL = CLOCK(DETECTION_INTERVAL_SEC, 
+					      DETECTION_INTERVAL_NS);
+static const Clock MIN_FORK_TIME = CLOCK(MIN_FORK_TIME_SEC, MIN_FORK_TIME_NS);
+static const Clock MAX_FORK_TIME = CLOCK(MAX_FORK_TIME_SEC, MAX_FORK_TIME_NS);
+#ifndef EVENT_DRIVEN
+static const Clock MAIN_LOOP_INCREMENT = CLOCK(LOOP_INCREMENT_SEC,
+					       LOOP_INCREMENT_NS);
 static const struct timespec SLEEP = {0, 500000};
+#endif
 
 // Static global variables
 static char * shm;				// Pointer to the shared memory region
 static ProtectedClock * systemClock;		// Shared memory system clock
-static ResourceDescriptor * resources;		// Shared memory resource table
+static ResourceTable resources;			// Shared memory resource table
 static Message * messages;			// Shared memory message vector
+static uint8_t * claims;			// Shared memory claim matrix
+static Channel * channels;			// Shared memory transport rings
+
+static pid_t * pidArray;			// Array of user process pids
+static Clock * launchTimes;			// Launch time of each process
+static bool * refusedUnsafe;			// Current request counted as unsafe
+static bool * claimRecorded;			// Claim of the process recorded
+static unsigned long * refusedAt;		// releaseVersion() at last refusal
+#ifdef WORKER_POOL
+static pid_t * workerPids;			// Pooled worker for each simPid
+#endif
+#ifdef IN_PROCESS_USERS
+static UserProcess * userProcesses;		// State of each simulated process
+#endif
+#ifdef THREADED_USERS
+static pthread_t * userThreads;			// Thread running each simPid
+#endif
+#ifdef COROUTINE_USERS
+static Coroutine * userCoroutines;		// Coroutine running each simPid
+#endif
+static int running = 0;				// Currently running child count
+static int launched = 0;			// Total children launched
+
+static ResourceSet dirty;	// Classes with queues to check after the batch
+static ResourceSet grantableClasses; // Classes a waiter fits available in
+static bool avoidance = false;	// Grants only requests that leave a safe state
 
-static int requestMqId;	// Id of message queue for resource requests & release
-int replyMqId;		// Id of message queue for replies from oss
+#ifdef EVENT_DETECTION
+static bool detectionTriggered = false;	  // A request was enqueued
+static unsigned long lastCleanVersion = 0; // State version found deadlock-free
+#endif
 
 int main(int argc, char * argv[]){
 
 	exeName = argv[0];	// Assigns exeName for perrorExit
+	parseArguments(argc, argv);
 	assignSignalHandlers(); // Sets response to ctrl + C & alarm
 	openLogFile();		// Opens file written to in logging.c
 
@@ -76,21 +152,49 @@ int main(int argc, char * argv[]){
 
 	// Creates shared memory region and gets pointers
 	getSharedMemoryPointers(&shm, &systemClock, &resources, &messages, 
-				IPC_CREAT);
+				&claims, &channels, IPC_CREAT);
+
+	// Allocates arrays with an element per simPid
+	pidArray = allocArray(MAX_RUNNING, sizeof(pid_t));
+	launchTimes = allocArray(MAX_RUNNING, sizeof(Clock));
+	refusedUnsafe = allocArray(MAX_RUNNING, sizeof(bool));
+	claimRecorded = allocArray(MAX_RUNNING, sizeof(bool));
+	refusedAt = allocArray(MAX_RUNNING, sizeof(unsigned long));
+#ifdef WORKER_POOL
+	workerPids = allocArray(MAX_RUNNING, sizeof(pid_t));
+#endif
+#ifdef IN_PROCESS_USERS
+	userProcesses = allocArray(MAX_RUNNING, sizeof(UserProcess));
+#endif
+#ifdef THREADED_USERS
+	userThreads = allocArray(MAX_RUNNING, sizeof(pthread_t));
+#endif
+#ifdef COROUTINE_USERS
+	userCoroutines = allocArray(MAX_RUNNING, sizeof(Coroutine));
+	startScheduler(COROUTINE_THREADS, MAX_RUNNING, systemClock);
+#endif
 
-        // Creates message queues
-        requestMqId = getMessageQueue(REQUEST_MQ_KEY, MQ_PERMS | IPC_CREAT);
-        replyMqId = getMessageQueue(REPLY_MQ_KEY, MQ_PERMS | IPC_CREAT);
+        // Creates message queues or rings
+	initTransport(channels, true);
 
 	initStats();
 
 	// Initializes system clock and shared arrays
 	initPClock(systemClock);
-	initResources(resources);
+	initResources(&resources);
 	initMessageArray(messages);
+	initLiveMatrices(&resources);
+	clearResourceSet(&dirty);
+	clearResourceSet(&grantableClasses);
 	
 	// Generates processes, grants requests, and resolves deadlock in a loop
 	simulateResourceManagement();
+#ifdef WORKER_POOL
+	stopWorkers();
+#endif
+#ifdef COROUTINE_USERS
+	stopScheduler();
+#endif
 
 	logStats();
 
@@ -100,33 +204,20 @@ int main(int argc, char * argv[]){
 }
 
 // Generates processes, grants requests, and resolves deadlock in a loop
-void simulateResourceManagement(){
+#ifndef EVENT_DRIVEN
+static void simulateResourceManagement(){
 	Clock timeToFork = zeroClock();		 // Time to launch user process 
 	Clock timeToDetect = DETECTION_INTERVAL; // Time to resolve deadlock
+	int m;					 // Message index
 
-	pid_t pidArray[MAX_RUNNING];		// Array of user process pids
 	initPidArray(pidArray);			// Sets pids to -1
-	pid_t simPid;				// Temporary pid storage
-
-	int running = 0;			// Currently running child count
-	int launched = 0;			// Total children launched
-	int terminated = 0;			// Killed last deadlock res.
-	int m;					// Message index
 
 	// Launches processes and resolves deadlock until limits reached
 	do {
 
 		// Launches user processes at random times
 		if (clockCompare(getPTime(systemClock), timeToFork) >= 0){
-			 
-			// Launches process & records real pid if within limits
-			if (running < MAX_RUNNING && launched < MAX_LAUNCHED){
-				simPid = getLogicalPid(pidArray);
-				pidArray[simPid] = launchUserProcess(simPid);
-
-				running++;
-				launched++;
-			}
+			launchIfAble();
 
 			// Selects new random time to launch a new user process
 			incrementClock(&timeToFork, randomTime(MIN_FORK_TIME,
@@ -134,29 +225,15 @@ void simulateResourceManagement(){
 		}
 
 		// Responds to new messages from the queue
-		while ((m = parseMessage()) != -1){
-			if (messages[m].type == REQUEST){
-				processRequest(m);
-			} else if (messages[m].type == RELEASE) {
-				processRelease(m);
-			} else if (messages[m].type == TERMINATION){
-				processTermination(m, pidArray[m]);
-			
-				// Removes from running processes
-				pidArray[m] = EMPTY;
-				running--;
-			}
-		}
+		while ((m = parseMessage()) != -1)
+			respondToMessage(m);
+
+		// Grants queued requests using resources released by the batch
+		endMessageBatch();
 
 		// Detects and resolves deadlock at regular intervals
 		if (clockCompare(getPTime(systemClock), timeToDetect) >= 0){
-			logDeadlockDetection(systemClock->time);
-
-			// Resolves deadlock
-			terminated = resolveDeadlock(pidArray, resources, 
-						   messages);
-			if (terminated > 0) processAllQueuedRequests();
-			running -= terminated;
+			detectAndResolveDeadlock();
 
 			// Selects new time to detect deadlock
 			incrementClock(&timeToDetect, DETECTION_INTERVAL);
@@ -164,13 +241,210 @@ void simulateResourceManagement(){
 
 		// Increments and unlocks the system clock
 		incrementPClock(systemClock, MAIN_LOOP_INCREMENT);
+#ifdef COROUTINE_USERS
+		// Wakes a scheduler thread for coroutines due at the new time
+		wakeDueSleepers();
+#endif
 
 		nanosleep(&SLEEP, NULL);
 
 	} while ((running > 0 || launched < MAX_LAUNCHED));
 
 }
+#else
+// Event-driven version: handles events in time order without sleeping
+static void simulateResourceManagement(){
+	EventQueue events;	// Pending events ordered by simulated time
+	Event event;		// The event being handled
+	const Event * next;	// The next event due
+	Clock now;		// Temp storage for time
+	int m;			// Message index
+
+	initPidArray(pidArray);			// Sets pids to -1
+
+	// Schedules the first launch and deadlock detection
+	initEventQueue(&events);
+	pushEvent(&events, zeroClock(), FORK_EVENT, -1);
+	pushEvent(&events, DETECTION_INTERVAL, DETECTION_EVENT, -1);
+
+	// Handles events in time order until limits reached
+	do {
+		now = getPTime(systemClock);
+
+		// New messages are events due at the time they arrive
+		while ((m = parseMessage()) != -1)
+			pushEvent(&events, now, MESSAGE_EVENT, m);
+
+		next = peekEvent(&events);
+
+		// Grants queued requests using resources released by the batch
+		if (next->type != MESSAGE_EVENT 
+		    || clockCompare(next->time, now) > 0)
+			endMessageBatch();
+
+		// Moves the clock straight to the next event if none are due
+		if (clockCompare(next->time, now) > 0){
+#ifdef TIMER_WAKE
+			// Stops first where a sleeping child is due to decide
+			Clock wake = earliestTimer();
+			advancePClock(systemClock, clockCompare(wake, now) > 0
+				      && clockCompare(wake, next->time) < 0
+				      ? wake : next->time);
+#else
+			advancePClock(systemClock, next->time);
+#endif
+#ifdef COROUTINE_USERS
+			// Wakes a scheduler thread for coroutines due at the new time
+			wakeDueSleepers();
+#endif
+
+			// Lets children act on the new time without sleeping
+			sched_yield();
+			continue;
+		}
+
+		event = popEvent(&events);
+
+		switch (event.type){
+		case MESSAGE_EVENT:
+			respondToMessage(event.simPid);
+			break;
+
+		case FORK_EVENT:
+			launchIfAble();
+
+			// Schedules the next launch while more remain
+			if (launched < MAX_LAUNCHED)
+				pushEvent(&events, clockSum(event.time,
+					  randomTime(MIN_FORK_TIME,
+					  MAX_FORK_TIME)), FORK_EVENT, -1);
+			break;
+
+		case DETECTION_EVENT:
+			detectAndResolveDeadlock();
+
+			pushEvent(&events, clockSum(event.time,
+				  DETECTION_INTERVAL), DETECTION_EVENT, -1);
+			break;
+		}
+
+	} while ((running > 0 || launched < MAX_LAUNCHED));
+
+}
+#endif
+
+// Sets options from the command line, exiting with usage if one is invalid
+static void parseArguments(int argc, char * argv[]){
+	Dimensions d = dims;	// Dimensions given on the command line
+	int opt;
+
+	while ((opt = getopt(argc, argv, "ak:r:n:t:")) != -1){
+		switch (opt){
+		case 'a':
+			avoidance = true;
+			break;
+
+		case 'k':
+			if (!setVictimPolicy(optarg)) usageExit();
+			break;
+
+		case 'r':
+			d.numResources = atoi(optarg);
+			break;
+
+		case 'n':
+			d.maxRunning = atoi(optarg);
+			break;
+
+		case 't':
+			d.maxLaunched = atoi(optarg);
+			break;
+
+		default:
+			usageExit();
+		}
+	}
+
+	if (!setDimensions(d)) usageExit();
+}
+
+// Prints usage to stderr and exits
+static void usageExit(){
+	fprintf(stderr, "Usage: %s [-a] [-k policy] [-r resources] "
+		"[-n running] [-t total]\n"
+		"  -a  avoid deadlock with the banker's algorithm\n"
+		"  -r  number of resource classes, 1 to %d (default %d)\n"
+		"  -n  most processes running at once, 1 to %d (default %d)\n"
+		"  -t  total processes to launch (default %d)\n"
+		"Victim selection policies:\n", exeName, NUM_RESOURCES_LIMIT,
+		DEFAULT_NUM_RESOURCES, MAX_RUNNING_LIMIT, DEFAULT_MAX_RUNNING,
+		DEFAULT_MAX_LAUNCHED);
+	printVictimPolicies(stderr);
+	exit(1);
+}
+
+// Launches a user process & records its real pid if within limits
+static void launchIfAble(){
+	int simPid;
+
+	if (running < MAX_RUNNING && launched < MAX_LAUNCHED){
+		simPid = getLogicalPid(pidArray);
+#ifndef WORKER_POOL
+		pidArray[simPid] = launchUserProcess(simPid);
+#else
+		pidArray[simPid] = assignWorker(simPid);
+#endif
+		launchTimes[simPid] = getPTime(systemClock);
+
+		// The new process's claim is recorded with its first request
+		claimRecorded[simPid] = false;
+
+		running++;
+		launched++;
+	}
+}
+
+// Responds to the message most recently parsed from the sender with simPid m
+static void respondToMessage(int m){
+	if (messages[m].type == REQUEST){
+		processRequest(m);
+	} else if (messages[m].type == RELEASE) {
+		processRelease(m);
+	} else if (messages[m].type == TERMINATION){
+		processTermination(m, pidArray[m]);
+	
+		// Removes from running processes
+		pidArray[m] = EMPTY;
+		running--;
+	}
+}
+
+// Runs deadlock detection, killing processes until deadlock is resolved
+static void detectAndResolveDeadlock(){
+	int terminated;		// Killed this deadlock resolution
+
+#ifdef EVENT_DETECTION
+	// Skips the pass if nothing changed since a pass found no deadlock
+	if (stateVersion() == lastCleanVersion){
+		statsDeadlockDetectionSkipped();
+		return;
+	}
+#endif
+
+	logDeadlockDetection(getPTime(systemClock));
+
+	// Resolves deadlock
+	terminated = resolveDeadlock(pidArray, &resources, messages,
+				     launchTimes);
+	if (terminated > 0) processDirtyResourceQueues();
+	running -= terminated;
+
+#ifdef EVENT_DETECTION
+	if (terminated == 0) lastCleanVersion = stateVersion();
+#endif
+}
 
+#ifndef IN_PROCESS_USERS
 // Forks & execs a user process with the assigned logical pid, returns child pid
 static pid_t launchUserProcess(int simPid){
 	pid_t realPid;
@@ -185,60 +459,164 @@ static pid_t launchUserProcess(int simPid){
 		char sPid[BUFF_SZ];
 		sprintf(sPid, "%d", simPid);
 		
-		execl(USER_PROG_PATH, USER_PROG_PATH, sPid, NULL);
+		// Asks the process to declare a claim if avoiding deadlock
+		execl(USER_PROG_PATH, USER_PROG_PATH, sPid, 
+		      avoidance ? "-a" : NULL, NULL);
 		perrorExit("Failed to execl");
 	}
 
 	return realPid;
 }
+#elif defined(THREADED_USERS)
+// Starts a thread simulating the user process with the assigned logical pid,
+// returns the pid of oss, which stands in for the pid of a child
+static pid_t launchUserProcess(int simPid){
+	UserProcess * user = &userProcesses[simPid];
+	pthread_attr_t attributes;
+	sigset_t all, previous;
 
-// Parses & returns the pid of a newly received message, or -1 if there are none
-static int parseMessage(){
-	char msgText[MSG_SZ];	// Raw text of each message
-	int msgInt;		// Integer form of each message
-	int rNum;		// The index of the resource
-	int quantity;		// Quantity requested or released
+	initUserProcess(user, simPid, avoidance, systemClock, &resources,
+			messages, claims);
 
-	long int qMsgType;	// Raw type of msg
-	int simPid;		// simPid of sender
+	// Blocks signals in the thread so cleanUpAndExit runs on the main thread
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
 
-	if (getMessage(requestMqId, msgText, &qMsgType)){
-		simPid = (int)(qMsgType - 1);	// Subtract 1 to get simPid
-		msgInt = atoi(msgText);		// Converts to encoded int
+	// Starts the thread with a small stack so thousands can run
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, USER_THREAD_STACK_SZ);
+	errno = pthread_create(&userThreads[simPid], &attributes, 
+			       runUserThread, user);
+	pthread_attr_destroy(&attributes);
 
-		// Parses release messages
-		if (msgInt < 0){
-			quantity = -msgInt % (MAX_INST + 1);
-			rNum = -msgInt / (MAX_INST + 1);
-			messages[simPid].type = RELEASE;
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
 
+	if (errno != 0) perrorExit("Failed to create user thread");
 
-		// Parses request messages
-		} else if (msgInt > 0){
-			quantity = msgInt % (MAX_INST + 1);
-			rNum = msgInt / (MAX_INST + 1);
-			messages[simPid].type = REQUEST;
+	return getpid();
+}
 
-			logRequestDetection(simPid, rNum, quantity, 
-					    systemClock->time);
+// Seeds the thread's generator as userProgram seeds its process, then runs the
+// simulated process until it terminates or is killed
+static void * runUserThread(void * user){
+	seedRandom(BASE_SEED + ((UserProcess *)user)->simPid);
+	simulateProcess(user);
+	return NULL;
+}
+#else
+// Spawns a coroutine simulating the user process with the assigned logical
+// pid, returns the pid of oss, which stands in for the pid of a child
+static pid_t launchUserProcess(int simPid){
+	UserProcess * user = &userProcesses[simPid];
 
-		// Parses termination messages
-		} else {
-			messages[simPid].type = TERMINATION;
+	initUserProcess(user, simPid, avoidance, systemClock, &resources,
+			messages, claims);
+	user->suspend = suspendUserCoroutine;
 
+	spawnCoroutine(&userCoroutines[simPid], runUserCoroutine, user);
 
-			return simPid;
-		}
+	return getpid();
+}
+
+// Seeds the coroutine's own generator as userProgram seeds its process, then
+// runs the simulated process until it terminates or is killed
+static void runUserCoroutine(void * arg){
+	UserProcess * user = arg;
+
+	seedRandomState(&user->random, BASE_SEED + user->simPid);
+	useRandomState(&user->random);
+	simulateProcess(user);
+}
+
+// Sleeps until the clock reaches until, or parks until oss replies if until is
+// NULL, then draws from the process's own generator again, as it may resume
+// on a different thread
+static void suspendUserCoroutine(UserProcess * user, const Clock * until){
+	if (until != NULL)
+		sleepCoroutine(*until);
+	else
+		parkCoroutine();
+
+	useRandomState(&user->random);
+}
+#endif
+
+#ifdef WORKER_POOL
+// Starts a simulated process on the pooled worker for simPid, launching the
+// worker the first time simPid is used, and returns the worker's pid
+static pid_t assignWorker(int simPid){
+	if (workerPids[simPid] == 0){
+		workerPids[simPid] = launchUserProcess(simPid);
+		statsWorkerLaunched();
+	}
+
+	sendReply(simPid, OP_ASSIGN);
+	return workerPids[simPid];
+}
+
+// Tells each idle pooled worker to exit and waits for it
+static void stopWorkers(){
+	int simPid;
+	for (simPid = 0; simPid < MAX_RUNNING; simPid++){
+		if (workerPids[simPid] == 0) continue;
+
+		sendReply(simPid, OP_KILL);
+		waitForProcess(workerPids[simPid]);
+		workerPids[simPid] = 0;
+	}
+}
+#endif
+
+// Parses & returns the pid of a newly received message, or -1 if there are none
+static int parseMessage(){
+	MsgBody body;		// Binary body of each message
+	int simPid;		// simPid of sender
+
+	// Returns -1 if no messages found in message queue
+	if (!getRequest(&body, &simPid)) return -1;
+
+	messages[simPid].seq = body.seq;
+
+	switch (body.opcode){
+
+	// Parses release messages
+	case OP_RELEASE:
+		messages[simPid].type = RELEASE;
+		break;
 
-		// Sets values in shared array
-		messages[simPid].quantity = quantity;
-		messages[simPid].rNum = rNum;
+	// Parses request messages
+	case OP_REQUEST:
+		messages[simPid].type = REQUEST;
 
+		logRequestDetection(simPid, body.rNum, body.quantity, 
+				    getPTime(systemClock));
+		break;
+
+	// Parses termination messages
+	case OP_TERMINATE:
+		messages[simPid].type = TERMINATION;
 		return simPid;
-	}else{
-		// Returns -1 if no messages found in message queue
-		return -1;
+
+	default:
+		perrorExit("parseMessage - unknown opcode");
 	}
+
+	// Sets values in shared array
+	messages[simPid].quantity = body.quantity;
+	messages[simPid].rNum = body.rNum;
+
+	return simPid;
+}
+
+// Sends a reply with no payload to the process with the given simPid
+static void sendReply(int simPid, Opcode opcode){
+	MsgBody reply = newMsgBody(opcode, 0, 0, messages[simPid].seq);
+	postReply(simPid, &reply);
+
+#ifdef COROUTINE_USERS
+	// Readies the coroutine parked waiting for the reply
+	wakeCoroutine(&userCoroutines[simPid]);
+#endif
 }
 
 // Messages a program to terminate, releases its resources, and writes to log
@@ -246,7 +624,7 @@ void killProcess(int simPid, pid_t realPid){
 	int released[NUM_RESOURCES]; // Array of prevous resource allocations
 	
 	// Sends the message killing the process
-	sendMessage(replyMqId, KILL_MSG, simPid + 1);
+	sendReply(simPid, OP_KILL);
 
 	// Releases and records previously held resources, calls waitpid
 	finalizeTermination(released, simPid, realPid);
@@ -256,19 +634,16 @@ void killProcess(int simPid, pid_t realPid){
 	logRelease(released);
 }
 
-// Releases resources of a finished process, waits, checks queues, writes to log
+// Releases resources of a finished process, waits, writes to log
 static void processTermination(int simPid, pid_t realPid){
 
 	int released[NUM_RESOURCES]; // Array of prevous resource allocations
 
-	sendMessage(replyMqId, "termination confirmed", simPid + 1);
+	sendReply(simPid, OP_TERMINATED);
 
 	// Releases and records previously held resources, calls waitpid
 	finalizeTermination(released, simPid, realPid);
 
-	// Checks queued requests for released resources, grants if possible
-	processReleasedResourceQueues(released);
-
 	// Logging
 	logCompletion(simPid);
 #ifdef VERBOSE
@@ -281,7 +656,23 @@ static void processTermination(int simPid, pid_t realPid){
 static void finalizeTermination(int * released, int simPid, pid_t realPid){
 
 	releaseResources(released, simPid);
+#if defined(THREADED_USERS)
+	if ((errno = pthread_join(userThreads[simPid], NULL)) != 0)
+		perrorExit("Failed to join user thread");
+#elif defined(COROUTINE_USERS)
+	joinCoroutine(&userCoroutines[simPid]);
+#elif !defined(WORKER_POOL)
 	waitForProcess(realPid);
+#endif
+
+	// Withdraws a pending request before the message is reset
+	if (messages[simPid].currentQueue != NO_QUEUE){
+		recordDequeue(simPid, messages[simPid].rNum, 
+			      messages[simPid].quantity);
+		removeFromCurrentQueue(resources.waiting, messages,
+				       &messages[simPid]);
+		updateGrantable(messages[simPid].rNum);
+	}
 	resetMessage(&messages[simPid]);
 
 	// Validates the state of the simulated system
@@ -292,19 +683,26 @@ static void finalizeTermination(int * released, int simPid, pid_t realPid){
 
 // Counts resources previously held by the process as available, writes to array
 static void releaseResources(int * released, int simPid){
+	uint8_t * held = &resources.allocations[simPid*NUM_RESOURCES];
 	int r;
 	for (r = 0; r < NUM_RESOURCES; r++){
-		released[r] = resources[r].allocations[simPid];
+		released[r] = held[r];
 
 		// Increases numAvailable if the resoruce is not shared
-		if (!resources[r].shareable){
-			resources[r].numAvailable += \
-				resources[r].allocations[simPid];
+		if (!resources.shareable[r] && released[r] > 0){
+			resources.numAvailable[r] += released[r];
+			addResource(&dirty, r);
+			updateGrantable(r);
 		}
-		resources[r].allocations[simPid] = 0;
+		held[r] = 0;
+
+		if (released[r] > 0)
+			recordRelease(simPid, r, released[r], 
+				      resources.shareable[r]);
 	}
 }
 
+#ifndef IN_PROCESS_USERS
 // Waits for the process with pid equal to the realPid parameter
 static void waitForProcess(pid_t realPid){
 
@@ -316,13 +714,28 @@ static void waitForProcess(pid_t realPid){
                 perrorExit("waited for non-existent child");
 
 }
+#endif
 
 // Responds to a request for resources by granting it or enqueueing the request
 static void processRequest(int simPid){
 	Message * msg = &messages[simPid]; // The message to respond to
 
-	// Grants request if it is less than available
-	if (msg->quantity <= resources[msg->rNum].numAvailable){
+	// Counts a refusal of this request as unsafe at most once
+	refusedUnsafe[simPid] = false;
+
+	// Records the claim the process declared in the claim matrix once, as
+	// grants and releases keep its need up to date afterwards
+	if (avoidance){
+		if (!claimRecorded[simPid]){
+			recordClaim(simPid, &claims[simPid*NUM_RESOURCES]);
+			claimRecorded[simPid] = true;
+		}
+		if (msg->quantity > liveNeed()[simPid*NUM_RESOURCES + msg->rNum])
+			perrorExit("processRequest - request exceeds claim");
+	}
+
+	// Grants request if it is less than available and safe
+	if (grantable(msg)){
 		grantRequest(msg);
 
 	// Enqueues message otherwise
@@ -330,10 +743,17 @@ static void processRequest(int simPid){
 
 		// Logs request denial
 		logEnqueue(simPid, msg->quantity, msg->rNum, 
-			resources[msg->rNum].numAvailable);
+			resources.numAvailable[msg->rNum]);
 
-		enqueue(&resources[msg->rNum].waiting, msg);
+		enqueue(&resources.waiting[msg->rNum], messages, msg);
+		recordEnqueue(simPid, msg->rNum, msg->quantity);
+		updateGrantable(msg->rNum);
 		msg->type = PENDING_REQUEST;
+
+#ifdef EVENT_DETECTION
+		// Deadlock can only form when a request has to wait
+		detectionTriggered = true;
+#endif
 	}
 
 	// Validates the state of the simulated system
@@ -342,33 +762,29 @@ static void processRequest(int simPid){
 	validateState(buff);
 }
 
-// Examines a single request queue and grants old requests if able
+// Examines a single request queue from the front and grants old requests if
+// able, stopping once no remaining request is small enough to be granted
 static void processQueuedRequests(int rNum){
 	Message * msg;				// Stores each queued message	
-	Queue * q = &resources[rNum].waiting;	// The queue to process
-	int qCount = q->count;			// Initial number in queue
+	Queue * q = &resources.waiting[rNum];	// The queue to process
+	int p = q->front;			// simPid of the next message
 
 	int i = 0;
-	for ( ; i < qCount; i++){
+	for ( ; p != NO_MSG && q->minQuantity <= resources.numAvailable[rNum];
+	     i++){
 
-		msg = q->front;
-		if (msg == NULL)
-			perrorExit("processQueuedReuqest() - msg NULL");
+		msg = &messages[p];
+		p = msg->previous;
 
 		if (msg->quantity <= 0)
 			perrorExit("processQueuedRequests() - request <= 0");
 
-		// Grants request if possible
-		if (msg->quantity <= resources[rNum].numAvailable){
+		// Grants request in place if possible, leaving the rest in order
+		if (grantable(msg)){
 
+			recordDequeue(msg->simPid, rNum, msg->quantity);
+			removeFromCurrentQueue(resources.waiting, messages, msg);
 			grantRequest(msg);
-			dequeue(q);
-
-		// Re-enqueues if not
-		} else {
-
-			dequeue(q);
-			enqueue(q, msg);
 		}
 
 		// Validates the state of the simulated system
@@ -379,21 +795,50 @@ static void processQueuedRequests(int rNum){
 	}
 }
 
+// Returns true if the request in msg is no greater than the number available
+// and, when avoiding deadlock, granting it leaves the system in a safe state
+static bool grantable(Message * msg){
+	if (msg->quantity > resources.numAvailable[msg->rNum]) return false;
+	if (!avoidance) return true;
+
+	// Granting other requests never makes a refused one safe; only releases
+	// and new claims can, so the check is skipped until one happens
+	if (refusedUnsafe[msg->simPid] 
+	    && refusedAt[msg->simPid] == releaseVersion())
+		return false;
+
+	if (grantIsSafe(msg->simPid, msg->rNum, msg->quantity,
+			resources.shareable[msg->rNum]))
+		return true;
+
+	// Counts the request once, however often its queue is rechecked
+	if (!refusedUnsafe[msg->simPid]){
+		refusedUnsafe[msg->simPid] = true;
+		statsUnsafeGrantRefused();
+	}
+	refusedAt[msg->simPid] = releaseVersion();
+	return false;
+}
+
 // Grants a request for resources
 static void grantRequest(Message * msg){
 
 	// Increeases allocation and if not shareable, decreases availability
-	resources[msg->rNum].allocations[msg->simPid] += msg->quantity;
-	if (!resources[msg->rNum].shareable)
-		resources[msg->rNum].numAvailable -= msg->quantity;
+	resources.allocations[msg->simPid*NUM_RESOURCES + msg->rNum] 
+		+= msg->quantity;
+	if (!resources.shareable[msg->rNum])
+		resources.numAvailable[msg->rNum] -= msg->quantity;
+	recordGrant(msg->simPid, msg->rNum, msg->quantity,
+		    resources.shareable[msg->rNum]);
+	updateGrantable(msg->rNum);
 
 
 	// Prints granted request to log file
 	logAllocation(msg->simPid, msg->rNum, msg->quantity, 
-		      systemClock->time);
+		      getPTime(systemClock));
 
 	// Logs resource table every 20 granted requests by default
-	logTable(resources);
+	logTable(&resources);
 
 	// Resets msg
 	msg->quantity = 0;
@@ -406,23 +851,47 @@ static void grantRequest(Message * msg){
 	validateState(buff);
 
 	// Replies with acknowlegement
-	sendMessage(replyMqId, "request confirmed", msg->simPid + 1);
+	sendReply(msg->simPid, OP_GRANTED);
 }
 
-// Calls processQueuedRequest on all resource numbers
-static void processAllQueuedRequests(){
-	int i = 0;
-	for ( ; i < NUM_RESOURCES; i++){
-		processQueuedRequests(i);
+// Marks rNum grantable if its smallest waiting request fits what is available
+static void updateGrantable(int rNum){
+	if (resources.waiting[rNum].minQuantity <= resources.numAvailable[rNum])
+		addResource(&grantableClasses, rNum);
+	else
+		removeResource(&grantableClasses, rNum);
+}
+
+// Calls processQueuedRequest once on each resource released since last called
+// whose queue holds a request small enough to grant
+static void processDirtyResourceQueues(){
+	int r = 0;
+
+	// Any release can make a request for another class safe to grant
+	if (avoidance && nextResource(&dirty, 0) != -1)
+		while ((r = nextResource(&grantableClasses, r)) != -1)
+			addResource(&dirty, r++);
+
+	r = 0;
+	while ((r = nextResource(&dirty, r)) != -1){
+		removeResource(&dirty, r);
+		if (hasResource(&grantableClasses, r))
+			processQueuedRequests(r);
+		r++;
 	}
 }
 
-// Calls processQueuedRequest on resources in released vector
-static void processReleasedResourceQueues(int * released){
-	int i = 0;
-	for ( ; i < NUM_RESOURCES; i++){
-		if (released[i] > 0) processQueuedRequests(i);
+// Grants queued requests freed by the batch and runs detection if triggered
+static void endMessageBatch(){
+	processDirtyResourceQueues();
+
+#ifdef EVENT_DETECTION
+	// Runs detection when a request waited and no waiter can be granted
+	if (detectionTriggered && nextResource(&grantableClasses, 0) == -1){
+		detectionTriggered = false;
+		detectAndResolveDeadlock();
 	}
+#endif
 }
 
 // Releases resources from a process
@@ -430,43 +899,45 @@ static void processRelease(int simPid){
 	Message * msg = &messages[simPid];
 
 	logResourceRelease(simPid, msg->rNum, msg->quantity, 
-			   systemClock->time);
-
-	resources[msg->rNum].allocations[simPid] -= msg->quantity;
-
-	if (!resources[msg->rNum].shareable)
-		resources[msg->rNum].numAvailable += msg->quantity;
+			   getPTime(systemClock));
+
+	resources.allocations[simPid*NUM_RESOURCES + msg->rNum] 
+		-= msg->quantity;
+	recordRelease(simPid, msg->rNum, msg->quantity, 
+		      resources.shareable[msg->rNum]);
+
+	// Marks the class for queue processing at the end of the message batch
+	if (!resources.shareable[msg->rNum]){
+		resources.numAvailable[msg->rNum] += msg->quantity;
+		addResource(&dirty, msg->rNum);
+		updateGrantable(msg->rNum);
+	}
 
 	msg->quantity = 0;
 	msg->type = VOID;
 
-	processAllQueuedRequests();
-
 	// Validates the state of the simulated system
 	char buff[BUFF_SZ];
 	sprintf(buff, "processRelease(%d)", simPid);
 	validateState(buff);
 
 	// Replies with acknowlegement
-	sendMessage(replyMqId, "release confirmed", simPid + 1);
+	sendReply(simPid, OP_RELEASED);
 }
 
-// This function calls perrorExit if any allocation < 0 or allocation > existing
+// This function calls perrorExit if any allocation < 0 or allocation > existing.
+// Counts are unsigned, so one taken below 0 wraps to more than exist.
 static void validateState(char * functionName){
 	int i;
 	char buff[BUFF_SZ];
 
 	for (i = 0; i < NUM_RESOURCES; i++){
-		if (resources[i].numAvailable > resources[i].numInstances){
+		if (resources.numAvailable[i] > resources.numInstances[i]){
 			sprintf(buff, "After call to %s, %d of R%d are"\
 				" available, but only %d instances exist",
-				functionName, resources[i].numAvailable, i,
-				resources[i].numInstances);
+				functionName, resources.numAvailable[i], i,
+				resources.numInstances[i]);
 			perrorExit(buff);
-		} else if (resources[i].numAvailable < 0) {
-			sprintf(buff, "After call to %s, %d of R%d available",
-				functionName, resources[i].numAvailable, i);
-			perrorExit(buff); 
 		}
 	}
 }
@@ -521,17 +992,8 @@ static void cleanUp(){
 	// Kills all other processes in the same process group
 	kill(0, SIGQUIT);
 
-	// Destroys semaphore protecting system clock
-	while (pthread_mutex_destroy(&systemClock->sem) != 0 && errno == EBUSY);
-	if (errno == EINVAL){
-		char buff[BUFF_SZ];
-		sprintf(buff, "%s: Error: ", exeName);
-		perror("Attempted to destroy invalid semaphore");
-	}
-
-	// Removes message queues
-	removeMessageQueue(requestMqId);
-	removeMessageQueue(replyMqId);
+	// Removes message queues, if any
+	removeTransport();
 
 	closeLogFile();
 
@@ -1,6 +1,6 @@
 // oss.h was created by Mark Renard on 4/15/2020.
 //
-// This file exports the replyMqId variable to deadlockDetection.c so that
+// This file exports the killProcess function to deadlockDetection.c so that
 // killAProcess can send a message to a user process.
 
 #ifndef OSS_H
@@ -8,7 +8,6 @@
 
 #include <sys/types.h>
 
-int replyMqId;
 void processTerm(int simPid, bool killed);
 void killProcess(int simPid, pid_t realPid);
 
@@ -1,44 +1,54 @@
-#include <pthread.h>
+// protectedClock.c was created by Mark Renard on 4/11/2020.
+//
+// This file contains functions that read and advance a clock shared between
+// processes using atomic operations on its count of nanoseconds. With
+// TIMER_WAKE, moving the clock also wakes processes sleeping until the new time.
+
+#include <stdatomic.h>
 
 #include "clock.h"
 #include "protectedClock.h"
+#include "timerWake.h"
 
-// Initializes semaphore protecting the clock
-static void initializeSemaphore(pthread_mutex_t * mutex){
-        pthread_mutexattr_t attributes; // mutex attributes struct
-
-        // Initializes mutex attributes struct
-        pthread_mutexattr_init(&attributes);
-
-        // Specifies that the semaphore can be used by multiple processes
-        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
-
-        // Initializes the mutex with the attributes struct
-        pthread_mutex_init(mutex, &attributes);
-}
+#ifdef TIMER_WAKE
+// Orders the clock update before reading the earliest sleeper's wake time
+#define CLOCK_ORDER memory_order_seq_cst
+#else
+#define CLOCK_ORDER memory_order_relaxed
+#endif
 
 // Initializes a ProtectedClock
 void initPClock(ProtectedClock * pClockPtr){
-	pClockPtr->time = zeroClock();
-	initializeSemaphore(&pClockPtr->sem);
+	atomic_init(&pClockPtr->time, zeroClock());
 }
 
-// Locks and unlocks a semaphore to increment a ProtectedClock
+// Atomically increments a ProtectedClock
 void incrementPClock(ProtectedClock * pClockPtr, Clock increment){
-	pthread_mutex_lock(&pClockPtr->sem);
-	incrementClock(&pClockPtr->time, increment);
-	pthread_mutex_unlock(&pClockPtr->sem);
+	Clock time = atomic_fetch_add_explicit(&pClockPtr->time, increment, 
+					       CLOCK_ORDER) + increment;
+#ifdef TIMER_WAKE
+	wakeDueTimers(time);
+#else
+	(void)time;
+#endif
 }
 
-// Returns the value of the time in a ProtectedClock
-Clock getPTime(ProtectedClock * pClockPtr){
-	Clock time;
+// Moves a ProtectedClock forward to the given time if it is not already past it
+void advancePClock(ProtectedClock * pClockPtr, Clock time){
+	Clock now = atomic_load_explicit(&pClockPtr->time, 
+					 memory_order_relaxed);
 
-	pthread_mutex_lock(&pClockPtr->sem);
-	copyTime(&time, pClockPtr->time);
-	pthread_mutex_unlock(&pClockPtr->sem);
+	// Retries if another process moved the clock, unless past the target
+	while (now < time
+	       && !atomic_compare_exchange_weak_explicit(&pClockPtr->time, 
+			&now, time, CLOCK_ORDER, memory_order_relaxed));
 
-	return time;
+#ifdef TIMER_WAKE
+	wakeDueTimers(time);
+#endif
 }
 
-
+// Returns the value of the time in a ProtectedClock
+Clock getPTime(ProtectedClock * pClockPtr){
+	return atomic_load_explicit(&pClockPtr->time, CLOCK_ORDER);
+}
@@ -1,22 +1,23 @@
 // protectedClock.h was created by Mark Renard on 4/11/2020.
 //
 // This file defines a type used to extend the base clock type to allow
-// mutually exclusive access by multiple processes for writing.
+// access by multiple processes. The time is kept as one atomic count of
+// nanoseconds, so reads never wait and increments are a single fetch-add.
 
 #ifndef PROTECTEDCLOCK_H
 #define PROTECTEDCLOCK_H
 
+#include <stdatomic.h>
 #include <stdio.h>
-#include <pthread.h>
 #include "clock.h"
 
 typedef struct protectedClock {
-	Clock time;
-	pthread_mutex_t sem;
+	_Atomic Clock time;	// Nanoseconds since the simulation began
 } ProtectedClock;
 
 void initPClock(ProtectedClock * pClockPtr);
 void incrementPClock(ProtectedClock * pClockPtr, Clock increment);
+void advancePClock(ProtectedClock * pClockPtr, Clock time);
 Clock getPTime(ProtectedClock * pClockPtr);
 
 #endif
@@ -7,7 +7,6 @@
 #include <stdio.h>
 #include <sys/msg.h>
 #include <sys/stat.h>
-#include <string.h>
 
 #include "qMsg.h"
 #include "perrorExit.h"
@@ -21,51 +20,88 @@ int getMessageQueue(int key, int flags){
 	return msgQueueId;
 }
 
+// Returns a message body, with a payload only if the opcode carries one
+MsgBody newMsgBody(Opcode opcode, int rNum, int quantity, unsigned int seq){
+	MsgBody body;
+
+	body.opcode = opcode;
+	body.seq = seq;
+
+	// Requests and releases carry the resource index and quantity
+	if (opcode == OP_REQUEST || opcode == OP_RELEASE){
+		body.payloadLen = MSG_PAYLOAD_SZ;
+		body.rNum = rNum;
+		body.quantity = quantity;
+	} else {
+		body.payloadLen = 0;
+		body.rNum = 0;
+		body.quantity = 0;
+	}
+
+	return body;
+}
+
 // Adds a message to the message queue with the specified message queue id
-void sendMessage(int msgQueueId, const char * msgText, long int type){
+void sendMessage(int msgQueueId, const MsgBody * body, long int type){
 	qMsg msg;	// Buffer for the message to be sent
 
 	// Initializes message
 	msg.type = type;
-	strcpy(msg.str, msgText);
+	msg.body = *body;
 
-	// Sends message
-	if ((msgsnd(msgQueueId, (const void *)&msg, sizeof(msg.str), 0)) == -1){
+	// Sends only the header and the used part of the payload
+	if ((msgsnd(msgQueueId, (const void *)&msg, 
+		    MSG_HEADER_SZ + body->payloadLen, 0)) == -1){
 		fprintf(stderr, "Couldn't send msg of type %ld\n", type);
-		fprintf(stderr, "Msg: %s\n", msg.str);
+		fprintf(stderr, "Msg: opcode %d, R%d, quantity %d\n", 
+			body->opcode, body->rNum, body->quantity);
 		perrorExit("Couldn't send message");
 	}
 }
 
 // Blocks until a message of the selected type is recieved in the selected queue
-void waitForMessage(int msgQueueId, char * msgText, long int type){
+void waitForMessage(int msgQueueId, MsgBody * body, long int type){
 	qMsg msg;	// Buffer for message to be received
 
 	// Waits for message
 	if ((msgrcv(msgQueueId, (void *)&msg, \
-		sizeof(msg.str), type, 0)) == -1)
+		sizeof(msg.body), type, 0)) == -1)
 			perrorExit("Error waiting for message");
 
-	// Copies message text
-	strcpy(msgText, msg.str);
+	// Copies message body
+	*body = msg.body;
 }
 
 // Checks to see if a message has been sent, doesn't block if not
-int getMessage(int msgQueueId, char * msgText, long int * type ){
+int getMessage(int msgQueueId, MsgBody * body, long int * type ){
 	qMsg msg;	// Buffer for message to be recieved
 
-	if(msgrcv(msgQueueId, (void *)&msg, sizeof(msg.str), 0, IPC_NOWAIT) \
+	if(msgrcv(msgQueueId, (void *)&msg, sizeof(msg.body), 0, IPC_NOWAIT) \
 		== -1){
 		if (errno == ENOMSG) return 0;
 		else perrorExit("Error getting message");
 	}
 
-	strcpy(msgText, msg.str);
+	*body = msg.body;
 	*type = msg.type;
 	return 1;
 
 }
 
+// Gets a message of the selected type without blocking, returns 0 if none
+int pollMessage(int msgQueueId, MsgBody * body, long int type){
+	qMsg msg;	// Buffer for message to be recieved
+
+	if (msgrcv(msgQueueId, (void *)&msg, sizeof(msg.body), type, 
+		   IPC_NOWAIT) == -1){
+		if (errno == ENOMSG) return 0;
+		else perrorExit("Error polling for message");
+	}
+
+	*body = msg.body;
+	return 1;
+}
+
 // Removes the message queue with the specified id
 void removeMessageQueue(int msgQueueId){
 	if ((msgctl(msgQueueId, IPC_RMID, NULL)) == -1)
@@ -6,17 +6,41 @@
 #ifndef QMSG_H
 #define QMSG_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "constants.h"
 
+typedef enum opcode {
+	OP_REQUEST = 1, OP_RELEASE, OP_TERMINATE,	 // User process to oss
+	OP_GRANTED, OP_RELEASED, OP_TERMINATED, OP_KILL, // oss to user process
+	OP_ASSIGN					 // oss to pool worker
+} Opcode;
+
+// Fixed-width binary message: a header followed by payloadLen payload bytes
+typedef struct msgBody {
+	uint8_t opcode;		// What the message means (an Opcode)
+	uint8_t payloadLen;	// Number of payload bytes that are used
+	uint16_t seq;		// Sequence number of the request it concerns
+
+	int16_t rNum;		// Payload: the id of the resource
+	int16_t quantity;	// Payload: the quantity requested or released
+} MsgBody;
+
+#define MSG_HEADER_SZ offsetof(MsgBody, rNum)	// Bytes before the payload
+#define MSG_PAYLOAD_SZ (sizeof(MsgBody) - MSG_HEADER_SZ) // Max payload bytes
+
 typedef struct qmsg {
 	long int type;
-	char str[MSG_SZ];
+	MsgBody body;
 } qMsg;
 
+MsgBody newMsgBody(Opcode opcode, int rNum, int quantity, unsigned int seq);
 int getMessageQueue(int key, int flags);
-void sendMessage(int msgQueueId, const char * msgText, long int type);
-void waitForMessage(int msgQueueId, char * msgText, long int type);
-int getMessage(int msgQueueId, char * msgText, long int * type);
+void sendMessage(int msgQueueId, const MsgBody * body, long int type);
+void waitForMessage(int msgQueueId, MsgBody * body, long int type);
+int getMessage(int msgQueueId, MsgBody * body, long int * type);
+int pollMessage(int msgQueueId, MsgBody * body, long int type);
 void removeMessageQueue(int msgQueueId);
 
 #endif
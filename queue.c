@@ -8,128 +8,154 @@
 #include "perrorExit.h"
 #include <stdio.h>
 
-// Sets the values of pointers to null and count to 0
-void initializeQueue(Queue * qPtr){
-	qPtr->front = NULL;
-	qPtr->back = NULL;
+// Sets the front and back to NO_MSG, count to 0, and records the queue's index
+void initializeQueue(Queue * qPtr, int id){
+	qPtr->front = NO_MSG;
+	qPtr->back = NO_MSG;
 	qPtr->count = 0;
+	qPtr->id = id;
+	qPtr->minQuantity = NO_MIN;
+}
+
+// Lowers minQuantity if msg requests fewer than any message already queued
+static void addToMin(Queue * q, const Message * msg){
+	if (msg->quantity < q->minQuantity) q->minQuantity = msg->quantity;
+}
+
+// Recomputes minQuantity by walking the queue if msg, just unlinked, held it
+static void removeFromMin(Queue * q, const Message * messages, 
+			  const Message * msg){
+	if (msg->quantity > q->minQuantity) return;
+
+	int p = q->front;
+	q->minQuantity = NO_MIN;
+	while (p != NO_MSG){
+		addToMin(q, &messages[p]);
+		p = messages[p].previous;
+	}
 }
 
 // Prints the simPid of messages in the queue from front to back
-void printQueue(FILE * fp, const Queue * q){
-	Message * msg = q->front;
+void printQueue(FILE * fp, const Queue * q, const Message * messages){
+	int p = q->front;
 
-	while (msg != NULL){
-		fprintf(fp, " %02d", msg->simPid);
-		msg = msg->previous;
+	while (p != NO_MSG){
+		fprintf(fp, " %02d", p);
+		p = messages[p].previous;
 	}
 }
 
 // Adds a message to the front of the queue
-void addToFront(Queue * q, Message * msg){
-	if (msg->currentQueue != NULL)
-		perrorExit("addToFront on msg with non-null currentQueue");
+void addToFront(Queue * q, Message * messages, Message * msg){
+	if (msg->currentQueue != NO_QUEUE)
+		perrorExit("addToFront on msg already in a queue");
 
-	msg->next = NULL;
+	msg->currentQueue = q->id;
+	msg->next = NO_MSG;
 	msg->previous = q->front;
 
-	if (msg->previous != NULL)
-		msg->previous->next = msg;
+	if (msg->previous != NO_MSG)
+		messages[msg->previous].next = msg->simPid;
 
-	q->front = msg;
+	q->front = msg->simPid;
 
 	// Adds to back as well if previously empty
-	if (q->back == NULL) q->back = msg;
+	if (q->back == NO_MSG) q->back = msg->simPid;
 	q->count++;
+	addToMin(q, msg);
 	
 }
 
 // Adds a message to the back of the queue
-void enqueue(Queue * q, Message * msg){
+void enqueue(Queue * q, Message * messages, Message * msg){
 
-	if (msg->currentQueue != NULL)
-		perrorExit("Tried to enqueue msg with non-null currentQueue");
+	if (msg->currentQueue != NO_QUEUE)
+		perrorExit("Tried to enqueue msg already in a queue");
 
-	msg->currentQueue = q;
+	msg->currentQueue = q->id;
 
 	// Adds message to queue	
-	if (q->back != NULL){
+	if (q->back != NO_MSG){
 
 		// Connects to back of queue if queue is not empty
-		q->back->previous = msg;
+		messages[q->back].previous = msg->simPid;
 		msg->next = q->back;
 	} else {
 		// Adds to front if queue is empty
-		q->front = msg;
-		msg->next = NULL;
+		q->front = msg->simPid;
+		msg->next = NO_MSG;
 	}
-	q->back = msg;
+	q->back = msg->simPid;
 
 	// Back of queue shouldn't have a previous element
-	q->back->previous = NULL;
+	msg->previous = NO_MSG;
 
 	// Increments node count in queue
 	q->count++;
+	addToMin(q, msg);
 
 }
 
 // Removes and returns Message reference from the front of the queue
-Message * dequeue(Queue * q){
+Message * dequeue(Queue * q, Message * messages){
 
 	// Exits with an error message if queue is empty
-	if (q->count <= 0 || q->front == NULL || q->back == NULL)
+	if (q->count <= 0 || q->front == NO_MSG || q->back == NO_MSG)
 		perrorExit("Called dequeue on empty queue");
 
 	// Assigns current front of queue to returnVal
-	Message * returnVal = q->front;  	
+	Message * returnVal = &messages[q->front];
 	
 	// Removes the front node from the queue
-	q->front = q->front->previous; // Assigns new front of queue
-	if (q->front != NULL)
-		q->front->next = NULL;	// Front of queue shouldn't have a next
+	q->front = returnVal->previous; // Assigns new front of queue
+	if (q->front != NO_MSG)
+		messages[q->front].next = NO_MSG; // Front shouldn't have a next
 	else
-		q->back = NULL;	// Back is null if queue is empty
+		q->back = NO_MSG;	// Back is empty if queue is empty
 
 	// Removes links from dequeued element
-	returnVal->previous = NULL; 
-	returnVal->next = NULL;
-	returnVal->currentQueue = NULL;
+	returnVal->previous = NO_MSG; 
+	returnVal->next = NO_MSG;
+	returnVal->currentQueue = NO_QUEUE;
 
 	q->count--;
+	removeFromMin(q, messages, returnVal);
 	return returnVal;
 
 }
 
-// Removes a particular element from any place in its queue
-void removeFromCurrentQueue(Message * msg){
-	Queue * q = msg->currentQueue;
-
-	if (q == NULL) 
+// Removes a particular element from any place in its queue, which is found at
+// index currentQueue of queues
+void removeFromCurrentQueue(Queue * queues, Message * messages, Message * msg){
+	if (msg->currentQueue == NO_QUEUE) 
 		perrorExit("Tried to remove msg when not in queue");
 
-	if (q->front == NULL || q->back == NULL || q->count < 1)
+	Queue * q = &queues[msg->currentQueue];
+
+	if (q->front == NO_MSG || q->back == NO_MSG || q->count < 1)
 		perrorExit("Tried to remove msg from empty queue");
 
 	// Finds new front if msg is the front
-	if (q->front == msg)
+	if (q->front == msg->simPid)
 		q->front = msg->previous;
 
 	// Finds new back if msg is the back
-	if (q->back == msg)
+	if (q->back == msg->simPid)
 		q->back = msg->next;
 
 	// Connects previous node to next node
-	if (msg->next != NULL)
-		msg->next->previous = msg->previous;
+	if (msg->next != NO_MSG)
+		messages[msg->next].previous = msg->previous;
 
 	// Connects next node to previous node
-	if (msg->previous != NULL)
-		msg->previous->next = msg->next;
+	if (msg->previous != NO_MSG)
+		messages[msg->previous].next = msg->next;
 
-	// Sets msg queue pointers to null
-	msg->next = NULL;
-	msg->previous = NULL;
-	msg->currentQueue = NULL;
+	// Clears msg queue links
+	msg->next = NO_MSG;
+	msg->previous = NO_MSG;
+	msg->currentQueue = NO_QUEUE;
 	
 	q->count--;
+	removeFromMin(q, messages, msg);
 }
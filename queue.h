@@ -1,24 +1,34 @@
 // queue.h was created by Mark Renard on 2/5/2020 and modified on 4/17/2020.
 // This file defines function prototypes for a queue structure
+//
+// Queues link messages by their index in the shared Message array instead of
+// by pointer, so any process attached to shared memory can follow them. Each
+// function is passed that process's pointer to the array.
 
 #ifndef QUEUE_H
 #define QUEUE_H
 
 #include "message.h"
+#include <stdint.h>
 #include <stdio.h>
 
+#define NO_MSG (-1)		// Link or end of a queue with no message
+#define NO_QUEUE (-1)		// currentQueue of a message in no queue
+#define NO_MIN INT16_MAX	// minQuantity of an empty queue
+
 typedef struct queue {
-	Message * back;
-	Message * front;
-	int count;
+	int16_t back;		// simPid of the message at the back
+	int16_t front;		// simPid of the message at the front
+	int16_t count;		// Number of messages in the queue
+	int16_t id;		// Index of the queue, stored in currentQueue
+	int16_t minQuantity;	// Smallest quantity requested in the queue
 } Queue;
 
-void printQueue(FILE *, const Queue *);
-void addToFront(Queue * q, Message * pcb);
-void initializeQueue(Queue *);
-void enqueue(Queue *, Message *);
-Message * dequeue(Queue *);
-void removeFromCurrentQueue(Message *);
+void printQueue(FILE *, const Queue *, const Message * messages);
+void addToFront(Queue * q, Message * messages, Message * pcb);
+void initializeQueue(Queue *, int id);
+void enqueue(Queue *, Message * messages, Message *);
+Message * dequeue(Queue *, Message * messages);
+void removeFromCurrentQueue(Queue * queues, Message * messages, Message *);
 
 #endif
-
@@ -1,13 +1,53 @@
 // randomGen.c was created by Mark Renard on 3/26/2020
 //
 // This file contains functions for generating random numbers of various types.
-// These should be used in a program where srand was called at some point.
+// These should be used in a program where srand was called at some point, or
+// in a thread that called seedRandom or useRandomState. Such a thread draws
+// from its own generator, which gives the same sequence srand would.
 //
 // randUnsigned inpired by:
 // https://bytes.com/topic/c/answers/135812-random-number-if-range-greater-than-rand_max
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#include "perrorExit.h"
+#include "randomGen.h"
+
+static _Thread_local RandomState threadState;	// Seeded by seedRandom
+static _Thread_local RandomState * inUse = NULL; // Drawn from, rand if NULL
+
+// Seeds a generator, giving the sequence srand(seed) would
+void seedRandomState(RandomState * rs, unsigned int seed){
+	memset(&rs->data, 0, sizeof(rs->data));
+	if (initstate_r(seed, rs->state, RANDOM_STATE_SZ, &rs->data) == -1)
+		perrorExit("seedRandomState - initstate_r failed");
+}
+
+// Makes the calling thread draw from rs, or from rand if rs is NULL
+void useRandomState(RandomState * rs){
+	inUse = rs;
+}
+
+// Seeds a generator used only by the calling thread
+void seedRandom(unsigned int seed){
+	seedRandomState(&threadState, seed);
+	useRandomState(&threadState);
+}
+
+// Returns the next value from the generator the thread uses, or from rand if
+// it uses none
+static int nextRandom(){
+	int32_t result;
+
+	if (inUse == NULL) return rand();
+
+	random_r(&inUse->data, &result);
+	return result;
+}
 
 // Random int in range overlaping with [0, (RAND_MAX + 1) * RAND_MAX + RAND_MAX]
 unsigned int randUnsigned(unsigned int min, unsigned int max){
@@ -22,7 +62,8 @@ unsigned int randUnsigned(unsigned int min, unsigned int max){
 
 	// Throws out overrepresented values to de-bias PRNG
 	do {
-		rawRandom = ((unsigned int)RAND_MAX + 1) * rand() + rand();
+		rawRandom = ((unsigned int)RAND_MAX + 1) * nextRandom() 
+			    + nextRandom();
 	} while (rawRandom > maxRawRandom - maxRawRandom % rangeSize);
 
 	return rawRandom % rangeSize + min;
@@ -35,7 +76,7 @@ int randInt(int min, int max){
 
 	// Throws out overrepresented values to de-bias PRNG
 	do {
-		rawRandom = rand();
+		rawRandom = nextRandom();
 	} while (rawRandom > RAND_MAX - RAND_MAX % rangeSize);
 
 	return rawRandom % rangeSize + min;
@@ -45,5 +86,5 @@ int randInt(int min, int max){
 int randBinary(double probability){
 	int threshold = (int)(RAND_MAX * probability);
 
-	return rand() < threshold ? 1 : 0;
+	return nextRandom() < threshold ? 1 : 0;
 }
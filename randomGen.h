@@ -1,11 +1,24 @@
 // randomGen.h was created by Mark Renard on 3/26/2020
 //
 // This file contains prototypes for functions related to random number
-// generation, which should be called after srand has been called.
+// generation, which should be called after srand or seedRandom has been called.
 
 #ifndef RANDOMGEN_H
 #define RANDOMGEN_H
 
+#include <stdlib.h>
+
+#define RANDOM_STATE_SZ 128	// State bytes used by rand in glibc
+
+// Generator that can be handed between threads, such as one per coroutine
+typedef struct randomState {
+	struct random_data data;	// Position in the sequence
+	char state[RANDOM_STATE_SZ];	// Buffer the position refers to
+} RandomState;
+
+void seedRandomState(RandomState *, unsigned int seed);
+void useRandomState(RandomState *);
+void seedRandom(unsigned int seed);
 unsigned int randUnsigned(unsigned int min, unsigned int max);
 int randInt(int min, int max);
 int randBinary(double probability);
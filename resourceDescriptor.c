@@ -1,30 +1,58 @@
 // resourceDescriptor.c was created by Mark Renard on 4/14/2020.
 //
-// This file contains the defintion of a function that initializes an array
-// of resource descriptors.
+// This file contains the defintion of a function that initializes the
+// resource table, and of functions that place its arrays in shared memory.
 
 #include "resourceDescriptor.h"
 #include "randomGen.h"
 #include "constants.h"
 
+// Returns the number of bytes of shared memory used by the table's arrays
+int resourceTableSize(){
+	return sizeof(Queue) * NUM_RESOURCES
+	       + sizeof(bool) * NUM_RESOURCES
+	       + sizeof(uint8_t) * NUM_RESOURCES * 2
+	       + sizeof(uint8_t) * NUM_RESOURCES * MAX_RUNNING;
+}
+
+// Points the table at its arrays in shared memory starting at base
+void placeResourceTable(ResourceTable * table, char * base){
+
+	// Queues hold int16_t fields, so they come before the byte arrays to
+	// keep them aligned
+	table->waiting = (Queue *)base;
+	base += sizeof(Queue) * NUM_RESOURCES;
+
+	table->shareable = (bool *)base;
+	base += sizeof(bool) * NUM_RESOURCES;
+
+	table->numInstances = (uint8_t *)base;
+	base += sizeof(uint8_t) * NUM_RESOURCES;
+
+	table->numAvailable = (uint8_t *)base;
+	base += sizeof(uint8_t) * NUM_RESOURCES;
+
+	table->allocations = (uint8_t *)base;
+}
+
 // Initializes resource with random instances and a chance of being shareable
-void initResources(ResourceDescriptor * descriptors){
-	int i, j;
+void initResources(ResourceTable * table){
+	int i;
 	for(i = 0; i < NUM_RESOURCES; i++){
 
 		// Resource is shareable with some probability (.2 by default)
-		descriptors[i].shareable = randBinary(SHAREABLE_PROBABILITY);
+		table->shareable[i] = randBinary(SHAREABLE_PROBABILITY);
 
 		// Resource has a random number of instances (default 1 to 10)
-		descriptors[i].numInstances = randInt(MIN_INST, MAX_INST);
+		table->numInstances[i] = randInt(MIN_INST, MAX_INST);
 
 		// All instances begin as available
-		descriptors[i].numAvailable = descriptors[i].numInstances;
-		
-		// Sets number allocated to each process to 0
-		for(j = 0; j < MAX_RUNNING; j++)
-			descriptors[i].allocations[j] = 0;
+		table->numAvailable[i] = table->numInstances[i];
 
+		initializeQueue(&table->waiting[i], i);
 	}
 
+	// Sets number allocated to each process to 0
+	for(i = 0; i < NUM_RESOURCES * MAX_RUNNING; i++)
+		table->allocations[i] = 0;
 }
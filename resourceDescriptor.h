@@ -1,7 +1,10 @@
 // resourceDescriptor.h was created by Mark Renard on 4/11/2020.
 //
-// This file contains the definition of a ResourceDescriptor, which records
-// allocation information for instances of a simulated resource.
+// This file contains the definition of a ResourceTable, which records
+// allocation information for instances of the simulated resources. Each field
+// of the table is a dense array in shared memory, so a process's allocations
+// are contiguous and counts take one byte. The table itself holds pointers
+// into the caller's mapping and is filled in by getSharedMemoryPointers.
 
 #ifndef RESOURCEDESCRIPTOR_H
 #define RESOURCEDESCRIPTOR_H
@@ -9,16 +12,28 @@
 #include "constants.h"
 #include "queue.h"
 #include <stdbool.h>
+#include <stdint.h>
 
-typedef struct resourceDescriptor{
-	bool shareable;			// Whether the resource is shareable
-	int numInstances;		// Total number of existing instances
-	int numAvailable;		// Number of unclaimed instances
-	int allocations[MAX_RUNNING];	// Number owned by each logical pid
+#if MAX_INST > UINT8_MAX
+#error "Instance counts are stored in a uint8_t"
+#endif
+
+typedef struct resourceTable{
+	bool * shareable;		// Whether each resource is shareable
+	uint8_t * numInstances;		// Total number of existing instances
+	uint8_t * numAvailable;		// Number of unclaimed instances
+	uint8_t * allocations;		// Number owned by each logical pid,
+					// indexed simPid*NUM_RESOURCES + rNum
+	Queue * waiting;		// Queue of pending requests
+	Message * messages;		// Messages linked by the queues
+} ResourceTable;
+
+// Returns the number of bytes of shared memory used by the table's arrays
+int resourceTableSize();
 
-	Queue waiting;			// Queue of pending requests
-} ResourceDescriptor;
+// Points the table at its arrays in shared memory starting at base
+void placeResourceTable(ResourceTable *, char * base);
 
-void initResources(ResourceDescriptor *);
+void initResources(ResourceTable *);
 
 #endif
@@ -0,0 +1,46 @@
+// resourceSet.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines functions that operate on a bitmap of resource classes.
+
+#include "resourceSet.h"
+
+// Removes all resource classes from the set
+void clearResourceSet(ResourceSet * set){
+	int i = 0;
+	for ( ; i < RESOURCE_SET_WORDS; i++)
+		set->words[i] = 0;
+}
+
+// Adds a resource class to the set
+void addResource(ResourceSet * set, int rNum){
+	set->words[rNum / WORD_BITS] |= 1UL << (rNum % WORD_BITS);
+}
+
+// Removes a resource class from the set
+void removeResource(ResourceSet * set, int rNum){
+	set->words[rNum / WORD_BITS] &= ~(1UL << (rNum % WORD_BITS));
+}
+
+// Returns true if the resource class is in the set
+bool hasResource(const ResourceSet * set, int rNum){
+	return (set->words[rNum / WORD_BITS] >> (rNum % WORD_BITS)) & 1UL;
+}
+
+// Returns the smallest class in the set that is >= rNum, or -1 if none
+int nextResource(const ResourceSet * set, int rNum){
+	int i = rNum / WORD_BITS;
+	unsigned long word;
+
+	if (rNum >= NUM_RESOURCES) return -1;
+
+	// Ignores classes below rNum in the first word examined
+	word = set->words[i] & (~0UL << (rNum % WORD_BITS));
+
+	// Skips empty words
+	while (word == 0){
+		if (++i >= RESOURCE_SET_WORDS) return -1;
+		word = set->words[i];
+	}
+
+	return i * WORD_BITS + __builtin_ctzl(word);
+}
@@ -0,0 +1,27 @@
+// resourceSet.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines a bitmap of resource class indices used by oss to record
+// which resource classes need attention.
+
+#ifndef RESOURCESET_H
+#define RESOURCESET_H
+
+#include <stdbool.h>
+#include "constants.h"
+
+#define WORD_BITS (8 * sizeof(unsigned long))	// Bits per bitmap word
+#define RESOURCE_SET_WORDS ((NUM_RESOURCES + WORD_BITS - 1) / WORD_BITS)
+#define RESOURCE_SET_CAPACITY \
+	((NUM_RESOURCES_LIMIT + WORD_BITS - 1) / WORD_BITS)
+
+typedef struct resourceSet {
+	unsigned long words[RESOURCE_SET_CAPACITY];	// One bit per class
+} ResourceSet;
+
+void clearResourceSet(ResourceSet *);
+void addResource(ResourceSet *, int rNum);
+void removeResource(ResourceSet *, int rNum);
+bool hasResource(const ResourceSet *, int rNum);
+int nextResource(const ResourceSet *, int rNum);
+
+#endif
@@ -0,0 +1,166 @@
+// rowKernels.c was created by Mark Renard on 10/16/2026.
+//
+// This file contains scalar, SSE4.1, and AVX2 versions of the row kernels used
+// in deadlock detection. Rows are short (one int per resource class), so the
+// vector versions handle the leftover columns with masked loads and stores or
+// a short scalar loop rather than requiring padded rows.
+
+#include <immintrin.h>
+#include <stdbool.h>
+
+#include "rowKernels.h"
+
+// Function pointer types of the kernels
+typedef bool (*RowFitsKernel)(const int *, const int *, int);
+typedef void (*RowAddKernel)(int *, const int *, int);
+
+static bool selectRowFits(const int * req, const int * avail, int m);
+static void selectRowAdd(int * acc, const int * row, int m);
+
+// Kernels in use, replaced by the best available on first call
+static RowFitsKernel rowFitsKernel = selectRowFits;
+static RowAddKernel rowAddKernel = selectRowAdd;
+static const char * kernelName = "unselected";
+
+// Scalar versions
+
+static bool rowFitsScalar(const int * req, const int * avail, int m){
+	int i = 0;
+	for ( ; i < m; i++)
+		if (req[i] > avail[i]) return false;
+
+	return true;
+}
+
+static void rowAddScalar(int * acc, const int * row, int m){
+	int i = 0;
+	for ( ; i < m; i++)
+		acc[i] += row[i];
+}
+
+// SSE4.1 versions, four columns per instruction
+
+__attribute__((target("sse4.1")))
+static bool rowFitsSse4(const int * req, const int * avail, int m){
+	__m128i over = _mm_setzero_si128();	// Lanes where req > avail
+	int i = 0;
+
+	for ( ; i + 4 <= m; i += 4){
+		__m128i r = _mm_loadu_si128((const __m128i *)&req[i]);
+		__m128i a = _mm_loadu_si128((const __m128i *)&avail[i]);
+		over = _mm_or_si128(over, _mm_cmpgt_epi32(r, a));
+	}
+
+	if (!_mm_testz_si128(over, over)) return false;
+
+	return rowFitsScalar(&req[i], &avail[i], m - i);
+}
+
+__attribute__((target("sse4.1")))
+static void rowAddSse4(int * acc, const int * row, int m){
+	int i = 0;
+
+	for ( ; i + 4 <= m; i += 4){
+		__m128i a = _mm_loadu_si128((const __m128i *)&acc[i]);
+		__m128i r = _mm_loadu_si128((const __m128i *)&row[i]);
+		_mm_storeu_si128((__m128i *)&acc[i], _mm_add_epi32(a, r));
+	}
+
+	rowAddScalar(&acc[i], &row[i], m - i);
+}
+
+// AVX2 versions, eight columns per instruction
+
+// Returns a mask selecting the first count of eight lanes
+__attribute__((target("avx2")))
+static __m256i tailMask(int count){
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32(count),
+				  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+__attribute__((target("avx2")))
+static bool rowFitsAvx2(const int * req, const int * avail, int m){
+	__m256i over = _mm256_setzero_si256();	// Lanes where req > avail
+	__m256i r, a, mask;
+	int i = 0;
+
+	for ( ; i + 8 <= m; i += 8){
+		r = _mm256_loadu_si256((const __m256i *)&req[i]);
+		a = _mm256_loadu_si256((const __m256i *)&avail[i]);
+		over = _mm256_or_si256(over, _mm256_cmpgt_epi32(r, a));
+	}
+
+	// Masked lanes load as 0 in both rows, so they never compare greater
+	if (i < m){
+		mask = tailMask(m - i);
+		r = _mm256_maskload_epi32(&req[i], mask);
+		a = _mm256_maskload_epi32(&avail[i], mask);
+		over = _mm256_or_si256(over, _mm256_cmpgt_epi32(r, a));
+	}
+
+	return _mm256_testz_si256(over, over);
+}
+
+__attribute__((target("avx2")))
+static void rowAddAvx2(int * acc, const int * row, int m){
+	__m256i a, r, mask;
+	int i = 0;
+
+	for ( ; i + 8 <= m; i += 8){
+		a = _mm256_loadu_si256((const __m256i *)&acc[i]);
+		r = _mm256_loadu_si256((const __m256i *)&row[i]);
+		_mm256_storeu_si256((__m256i *)&acc[i], _mm256_add_epi32(a, r));
+	}
+
+	if (i < m){
+		mask = tailMask(m - i);
+		a = _mm256_maskload_epi32(&acc[i], mask);
+		r = _mm256_maskload_epi32(&row[i], mask);
+		_mm256_maskstore_epi32(&acc[i], mask, _mm256_add_epi32(a, r));
+	}
+}
+
+// Selects the widest kernels the CPU supports
+static void selectKernels(){
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")){
+		rowFitsKernel = rowFitsAvx2;
+		rowAddKernel = rowAddAvx2;
+		kernelName = "avx2";
+	} else if (__builtin_cpu_supports("sse4.1")){
+		rowFitsKernel = rowFitsSse4;
+		rowAddKernel = rowAddSse4;
+		kernelName = "sse4.1";
+	} else {
+		rowFitsKernel = rowFitsScalar;
+		rowAddKernel = rowAddScalar;
+		kernelName = "scalar";
+	}
+}
+
+static bool selectRowFits(const int * req, const int * avail, int m){
+	selectKernels();
+	return rowFitsKernel(req, avail, m);
+}
+
+static void selectRowAdd(int * acc, const int * row, int m){
+	selectKernels();
+	rowAddKernel(acc, row, m);
+}
+
+// Returns true if each of the m values in req is <= the value in avail
+bool rowFits(const int * req, const int * avail, int m){
+	return rowFitsKernel(req, avail, m);
+}
+
+// Adds each of the m values in row to the value in acc
+void rowAdd(int * acc, const int * row, int m){
+	rowAddKernel(acc, row, m);
+}
+
+// Returns the name of the kernel set selected for this CPU
+const char * rowKernelName(){
+	if (rowFitsKernel == selectRowFits) selectKernels();
+	return kernelName;
+}
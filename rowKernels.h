@@ -0,0 +1,21 @@
+// rowKernels.h was created by Mark Renard on 10/16/2026.
+//
+// This file contains headers for kernels that operate on one row of a
+// resource matrix. The SIMD version used is selected at runtime: AVX2 if the
+// CPU supports it, otherwise SSE4.1, otherwise a scalar loop.
+
+#ifndef ROWKERNELS_H
+#define ROWKERNELS_H
+
+#include <stdbool.h>
+
+// Returns true if each of the m values in req is <= the value in avail
+bool rowFits(const int * req, const int * avail, int m);
+
+// Adds each of the m values in row to the value in acc
+void rowAdd(int * acc, const int * row, int m);
+
+// Returns the name of the kernel set selected for this CPU
+const char * rowKernelName();
+
+#endif
@@ -14,6 +14,11 @@ void initStats(){
         stats.numProcessesCompleted = 0;
         stats.numTimesDeadlockDetectionRun = 0;
         stats.numTimesDeadlocked = 0;
+        stats.numTimesGraphDetectionRun = 0;
+        stats.numTimesDeadlockDetectionSkipped = 0;
+        stats.numUnsafeGrantsRefused = 0;
+        stats.numWorkersLaunched = 0;
+        stats.numLogRecordsDropped = 0;
 
 	stats.percentKilledPerDeadlock = -1.0;
 }
@@ -38,6 +43,31 @@ void statsDeadlockDetectionRun(){
 	stats.numTimesDeadlockDetectionRun++;
 }
 
+// Records the number of detection passes done with the wait-for graph
+void statsGraphDetectionRun(){
+	stats.numTimesGraphDetectionRun++;
+}
+
+// Records the number of detection passes skipped because nothing changed
+void statsDeadlockDetectionSkipped(){
+	stats.numTimesDeadlockDetectionSkipped++;
+}
+
+// Records a request that could be met but was refused as unsafe
+void statsUnsafeGrantRefused(){
+	stats.numUnsafeGrantsRefused++;
+}
+
+// Records a pooled worker process being launched
+void statsWorkerLaunched(){
+	stats.numWorkersLaunched++;
+}
+
+// Records a log record dropped because the log ring was full
+void statsLogRecordDropped(){
+	stats.numLogRecordsDropped++;
+}
+
 // Records number of times deadlock detected and percentage of processes killed
 void statsDeadlockResolved(int killed, int runningAtStart){
 	percentageAcc += (double)killed/(double)runningAtStart;
@@ -47,6 +77,12 @@ void statsDeadlockResolved(int killed, int runningAtStart){
 
 // Sets the percentage of running processes terminated per deadlock on average
 static void setPercentKilled(Stats * st){
+	// No deadlock is found when it is avoided
+	if (st->numTimesDeadlocked == 0){
+		st->percentKilledPerDeadlock = 0.0;
+		return;
+	}
+
 	st->percentKilledPerDeadlock = (double)percentageAcc \
 		/ (double)st->numTimesDeadlocked * 100;
 }
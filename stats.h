@@ -12,6 +12,11 @@ typedef struct stats {
 	unsigned long int numProcessesCompleted;
 	unsigned long int numTimesDeadlockDetectionRun;
 	unsigned long int numTimesDeadlocked;
+	unsigned long int numTimesGraphDetectionRun;
+	unsigned long int numTimesDeadlockDetectionSkipped;
+	unsigned long int numUnsafeGrantsRefused;
+	unsigned long int numWorkersLaunched;
+	unsigned long int numLogRecordsDropped;
 
 	double percentKilledPerDeadlock;
 } Stats;
@@ -21,6 +26,11 @@ void statsRequestGranted();
 void statsProcessKilled();
 void statsProcessCompleted();
 void statsDeadlockDetectionRun();
+void statsGraphDetectionRun();
+void statsDeadlockDetectionSkipped();
+void statsUnsafeGrantRefused();
+void statsWorkerLaunched();
+void statsLogRecordDropped();
 void statsDeadlockResolved(int, int);
 Stats getStats();
 
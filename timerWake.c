@@ -0,0 +1,157 @@
+// timerWake.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines functions that let a user process sleep until the
+// simulated clock reaches its next decision time instead of polling the
+// clock. A sleeper adds its simPid to a heap in shared memory and waits on its
+// futex word. Whoever moves the clock pops each sleeper that is due and wakes
+// it. The heap's earliest wake time is kept in an atomic, so moving the clock
+// only takes the lock when a sleeper is due.
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "dimensions.h"
+#include "futex.h"
+#include "protectedClock.h"
+#include "timerWake.h"
+
+#define ALIGN(offset) \
+	(((offset) + CACHE_LINE_SZ - 1) / CACHE_LINE_SZ * CACHE_LINE_SZ)
+
+static TimerHeap * header;	// Lock, earliest time and count
+static int * heap;		// simPids ordered by wake time
+static Timer * timers;		// Sleep state of each simPid
+
+// Returns the number of bytes of shared memory used
+size_t timerWakeSize(){
+	return ALIGN(ALIGN(sizeof(TimerHeap)) + sizeof(int) * MAX_RUNNING)
+	       + sizeof(Timer) * MAX_RUNNING;
+}
+
+// Points the heap into shared memory at base, initializing it if create
+void placeTimerWake(char * base, bool create){
+	int p;
+
+	header = (TimerHeap *)base;
+	heap = (int *)(base + ALIGN(sizeof(TimerHeap)));
+	timers = (Timer *)(base + ALIGN(ALIGN(sizeof(TimerHeap)) 
+				       + sizeof(int) * MAX_RUNNING));
+
+	if (!create) return;
+
+	atomic_flag_clear(&header->lock);
+	atomic_init(&header->earliest, NO_TIMER);
+	header->count = 0;
+
+	for (p = 0; p < MAX_RUNNING; p++)
+		atomic_init(&timers[p].wakes, 0);
+}
+
+// Spins, yielding the processor, until the heap lock is held
+static void lockHeap(){
+	while (atomic_flag_test_and_set_explicit(&header->lock, 
+						 memory_order_acquire))
+		sched_yield();
+}
+
+// Releases the heap lock
+static void unlockHeap(){
+	atomic_flag_clear_explicit(&header->lock, memory_order_release);
+}
+
+// Returns true if the sleeper at heap index a is due before the one at b
+static bool dueBefore(int a, int b){
+	return timers[heap[a]].wakeTime < timers[heap[b]].wakeTime;
+}
+
+// Swaps two heap entries
+static void swap(int a, int b){
+	int temp = heap[a];
+	heap[a] = heap[b];
+	heap[b] = temp;
+}
+
+// Publishes the wake time of the sleeper at the top of the heap
+static void updateEarliest(){
+	atomic_store(&header->earliest, header->count > 0 
+		     ? timers[heap[0]].wakeTime : NO_TIMER);
+}
+
+// Bumps the futex word of a sleeper and wakes it
+static void wakeTimer(int simPid){
+	atomic_fetch_add(&timers[simPid].wakes, 1);
+	futexWakeOne(&timers[simPid].wakes);
+}
+
+// Pops and wakes every sleeper due by now. Waking while the lock is held means
+// a sleeper never leaves the heap without being woken by whoever popped it.
+static void wakeDue(Clock now){
+	int i, child;
+
+	while (header->count > 0 && timers[heap[0]].wakeTime <= now){
+		wakeTimer(heap[0]);
+
+		// Moves the last sleeper down from the top of the heap
+		heap[0] = heap[--header->count];
+		i = 0;
+		while ((child = 2 * i + 1) < header->count){
+			if (child + 1 < header->count 
+			    && dueBefore(child + 1, child))
+				child++;
+			if (!dueBefore(child, i)) break;
+
+			swap(i, child);
+			i = child;
+		}
+	}
+
+	updateEarliest();
+}
+
+// Sleeps until clock reaches time, returning at once if it already has
+void sleepUntil(ProtectedClock * clock, int simPid, Clock time){
+	Timer * timer = &timers[simPid];
+	unsigned int seen = atomic_load(&timer->wakes);
+	int i;
+
+	if (getPTime(clock) >= time) return;
+
+	lockHeap();
+
+	// Adds simPid to the heap, moving it up until its parent is due first
+	timer->wakeTime = time;
+	i = header->count++;
+	heap[i] = simPid;
+	while (i > 0 && dueBefore(i, (i - 1) / 2)){
+		swap(i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+	updateEarliest();
+
+	// Wakes itself and any others if the clock passed time before the
+	// earliest time was published, since the mover may have missed them
+	wakeDue(getPTime(clock));
+
+	unlockHeap();
+
+	// Rechecks after each wake since futex waits may return spuriously
+	while (atomic_load(&timer->wakes) == seen)
+		futexWait(&timer->wakes, seen);
+}
+
+// Wakes every sleeper due by now
+void wakeDueTimers(Clock now){
+	if (atomic_load(&header->earliest) > now) return;
+
+	lockHeap();
+	wakeDue(now);
+	unlockHeap();
+}
+
+// Returns the earliest time a process is sleeping until, or NO_TIMER
+Clock earliestTimer(){
+	return atomic_load(&header->earliest);
+}
@@ -0,0 +1,40 @@
+// timerWake.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines a heap in shared memory of user processes sleeping until
+// the simulated clock reaches a time, and headers for functions that put a
+// process to sleep on a futex and wake those whose time has come. It is used
+// when built with -DTIMER_WAKE.
+
+#ifndef TIMERWAKE_H
+#define TIMERWAKE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "protectedClock.h"
+
+#define NO_TIMER UINT64_MAX	// earliest when no process is sleeping
+
+// Sleep state of one simPid
+typedef struct timer {
+	_Alignas(CACHE_LINE_SZ) atomic_uint wakes; // Futex word, bumped on wake
+	Clock wakeTime;				   // Time the sleeper is due
+} Timer;
+
+// Heap of sleeping simPids ordered by wake time
+typedef struct timerHeap {
+	atomic_flag lock;		// Spinlock guarding the heap
+	_Atomic Clock earliest;		// Wake time at the top, or NO_TIMER
+	int count;			// Number of sleepers
+} TimerHeap;
+
+size_t timerWakeSize();
+void placeTimerWake(char * base, bool create);
+void sleepUntil(ProtectedClock *, int simPid, Clock time);
+void wakeDueTimers(Clock now);
+Clock earliestTimer();
+
+#endif
@@ -0,0 +1,254 @@
+// transport.c was created by Mark Renard on 10/16/2026.
+//
+// This file contains the definitions of functions that pass messages between
+// oss and user processes. Requests travel through a SysV message queue or, if
+// built with -DSHM_RING, through lock-free rings in shared memory. Replies
+// travel the same way unless built with -DFUTEX_REPLY, in which case they are
+// posted to a slot per simPid and the user process waits on a futex.
+
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+
+#include "constants.h"
+#include "dimensions.h"
+#include "futex.h"
+#include "perrorExit.h"
+#include "qMsg.h"
+#include "transport.h"
+
+static Channel * channels;		// Shared memory rings, one per simPid
+
+#ifndef SHM_RING
+static int requestMqId;	// Id of message queue for resource requests & release
+#ifndef FUTEX_REPLY
+static int replyMqId;	// Id of message queue for replies from oss
+#endif
+#else
+static MsgBody * batch;			// Requests drained in the last pass
+static int * batchPids;			// simPid of each drained request
+static int batchSize = 0;		// Number of drained requests
+static int batchNext = 0;		// Next drained request to return
+#endif
+
+// Sets head and tail of a ring to 0
+static void initRing(MsgRing * ring){
+	atomic_init(&ring->head, 0);
+	atomic_init(&ring->tail, 0);
+}
+
+#ifdef SHM_RING
+
+// Writes a message to a ring, returns false if it is full
+static bool pushRing(MsgRing * ring, const MsgBody * body){
+	unsigned int tail = atomic_load_explicit(&ring->tail, 
+						 memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&ring->head, 
+						 memory_order_acquire);
+
+	if (tail - head == RING_SZ) return false;
+
+	ring->slots[tail % RING_SZ] = *body;
+
+	// Publishes the slot to the consumer
+	atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+	return true;
+}
+
+// Reads a message from a ring, returns false if it is empty
+static bool popRing(MsgRing * ring, MsgBody * body){
+	unsigned int head = atomic_load_explicit(&ring->head, 
+						 memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&ring->tail, 
+						 memory_order_acquire);
+
+	if (head == tail) return false;
+
+	*body = ring->slots[head % RING_SZ];
+
+	// Returns the slot to the producer
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+	return true;
+}
+
+// Writes a message to a ring, yielding until there is space
+static void pushRingWaiting(MsgRing * ring, const MsgBody * body){
+	while (!pushRing(ring, body))
+		sched_yield();
+}
+
+#endif
+
+// Sets the counts of a reply slot to 0
+static void initReplySlot(ReplySlot * slot){
+	atomic_init(&slot->posted, 0);
+	slot->taken = 0;
+}
+
+// Records the address of the rings, gets message queues if they are used, and
+// initializes the rings and reply slots if create is true
+void initTransport(Channel * shmChannels, bool create){
+	channels = shmChannels;
+
+#ifndef SHM_RING
+        requestMqId = getMessageQueue(REQUEST_MQ_KEY, MQ_PERMS | IPC_CREAT);
+#ifndef FUTEX_REPLY
+        replyMqId = getMessageQueue(REPLY_MQ_KEY, MQ_PERMS | IPC_CREAT);
+#endif
+#endif
+
+	if (!create) return;
+
+#ifdef SHM_RING
+	batch = allocArray(MAX_RUNNING, sizeof(MsgBody));
+	batchPids = allocArray(MAX_RUNNING, sizeof(int));
+#endif
+
+	int i;
+	for (i = 0; i < MAX_RUNNING; i++){
+		initRing(&channels[i].requests);
+		initRing(&channels[i].replies);
+		initReplySlot(&channels[i].reply);
+	}
+}
+
+// Removes the message queues, if any. Rings are removed with shared memory.
+void removeTransport(){
+#ifndef SHM_RING
+	removeMessageQueue(requestMqId);
+#ifndef FUTEX_REPLY
+	removeMessageQueue(replyMqId);
+#endif
+#endif
+}
+
+#ifndef SHM_RING
+
+// Sends a request with message type simPid + 1 (zero is not a valid type)
+void sendRequest(int simPid, const MsgBody * body){
+	sendMessage(requestMqId, body, simPid + 1);
+}
+
+// Gets a request from the queue and subtracts 1 from its type to get simPid
+int getRequest(MsgBody * body, int * simPid){
+	long int type;	// Raw type of msg
+
+	if (!getMessage(requestMqId, body, &type)) return 0;
+
+	*simPid = (int)(type - 1);
+	return 1;
+}
+
+#else
+
+// Writes a request to the ring for simPid
+void sendRequest(int simPid, const MsgBody * body){
+	pushRingWaiting(&channels[simPid].requests, body);
+}
+
+// Returns the next request, draining every ring in one pass when out of them
+int getRequest(MsgBody * body, int * simPid){
+	int p;
+
+	// Drains all rings once the previous pass has been consumed
+	if (batchNext == batchSize){
+		batchNext = batchSize = 0;
+
+		for (p = 0; p < MAX_RUNNING && batchSize < MAX_RUNNING; p++){
+			while (batchSize < MAX_RUNNING
+			       && popRing(&channels[p].requests,
+					  &batch[batchSize])){
+				batchPids[batchSize++] = p;
+			}
+		}
+
+		if (batchSize == 0) return 0;
+	}
+
+	*body = batch[batchNext];
+	*simPid = batchPids[batchNext++];
+	return 1;
+}
+
+#endif
+
+#if defined(FUTEX_REPLY)
+
+// Writes the reply to the slot for simPid and wakes its user process
+void postReply(int simPid, const MsgBody * body){
+	ReplySlot * slot = &channels[simPid].reply;
+	unsigned int posted = atomic_load_explicit(&slot->posted,
+						   memory_order_relaxed);
+
+	slot->bodies[posted % REPLY_DEPTH] = *body;
+
+	// Publishes the reply, then wakes the only process that can wait on it
+	atomic_fetch_add_explicit(&slot->posted, 1, memory_order_release);
+	futexWakeOne(&slot->posted);
+}
+
+// Sleeps on the futex for simPid until a reply has been posted
+void waitForReply(int simPid, MsgBody * body){
+	ReplySlot * slot = &channels[simPid].reply;
+	unsigned int posted;
+
+	// Rechecks after each wake since futex waits may return spuriously
+	while ((posted = atomic_load_explicit(&slot->posted, 
+			 memory_order_acquire)) == slot->taken)
+		futexWait(&slot->posted, posted);
+
+	*body = slot->bodies[slot->taken % REPLY_DEPTH];
+	slot->taken++;
+}
+
+// Reads the next reply posted to the slot for simPid if there is one
+int pollReply(int simPid, MsgBody * body){
+	ReplySlot * slot = &channels[simPid].reply;
+
+	if (atomic_load_explicit(&slot->posted, memory_order_acquire) 
+	    == slot->taken)
+		return 0;
+
+	*body = slot->bodies[slot->taken % REPLY_DEPTH];
+	slot->taken++;
+	return 1;
+}
+
+#elif defined(SHM_RING)
+
+// Writes a reply to the ring for simPid
+void postReply(int simPid, const MsgBody * body){
+	pushRingWaiting(&channels[simPid].replies, body);
+}
+
+// Yields until a reply is in the ring for simPid
+void waitForReply(int simPid, MsgBody * body){
+	while (!popRing(&channels[simPid].replies, body))
+		sched_yield();
+}
+
+// Reads a reply from the ring for simPid if there is one
+int pollReply(int simPid, MsgBody * body){
+	return popRing(&channels[simPid].replies, body);
+}
+
+#else
+
+// Sends a reply with message type simPid + 1
+void postReply(int simPid, const MsgBody * body){
+	sendMessage(replyMqId, body, simPid + 1);
+}
+
+// Waits for a reply with message type simPid + 1
+void waitForReply(int simPid, MsgBody * body){
+	waitForMessage(replyMqId, body, simPid + 1);
+}
+
+// Gets a reply with message type simPid + 1 if there is one
+int pollReply(int simPid, MsgBody * body){
+	return pollMessage(replyMqId, body, simPid + 1);
+}
+
+#endif
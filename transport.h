@@ -0,0 +1,65 @@
+// transport.h was created by Mark Renard on 10/16/2026.
+//
+// This file contains headers for the transport that carries MsgBody requests
+// from user processes to oss and replies back. By default the SysV message
+// queues in qMsg.c are used. When built with -DSHM_RING, each simPid instead
+// has a pair of lock-free single-producer/single-consumer rings in shared
+// memory.
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "constants.h"
+#include "qMsg.h"
+
+// Ring of messages written by exactly one process and read by exactly one
+typedef struct msgRing {
+	_Alignas(CACHE_LINE_SZ) atomic_uint head;  // Next slot to read
+	_Alignas(CACHE_LINE_SZ) atomic_uint tail;  // Next slot to write
+	MsgBody slots[RING_SZ];			   // Buffered messages
+} MsgRing;
+
+// Replies that may be posted before the user process reads them: a process's
+// final reply and the next assignment to its pooled worker
+#define REPLY_DEPTH 2
+
+// Holds the outstanding replies to a user process
+typedef struct replySlot {
+	_Alignas(CACHE_LINE_SZ) atomic_uint posted; // Replies posted, futex word
+	unsigned int taken;			    // Replies read by the user
+	MsgBody bodies[REPLY_DEPTH];		    // Latest replies by count
+} ReplySlot;
+
+// Rings and reply slot connecting oss to the user process with one simPid
+typedef struct channel {
+	MsgRing requests;	// User process to oss
+	MsgRing replies;	// oss to user process
+	ReplySlot reply;	// oss to user process (FUTEX_REPLY)
+} Channel;
+
+// Connects to the transport, creating and initializing it if create is true
+void initTransport(Channel * channels, bool create);
+
+// Removes message queues created by initTransport
+void removeTransport();
+
+// Sends a message from the user process with simPid to oss
+void sendRequest(int simPid, const MsgBody * body);
+
+// Gets a message sent to oss without blocking, returns 0 if there are none
+int getRequest(MsgBody * body, int * simPid);
+
+// Sends a reply from oss to the user process with simPid
+void postReply(int simPid, const MsgBody * body);
+
+// Blocks until oss replies to the user process with simPid
+void waitForReply(int simPid, MsgBody * body);
+
+// Gets a reply to the user process with simPid without blocking, returns 0 if
+// there is none
+int pollReply(int simPid, MsgBody * body);
+
+#endif
@@ -0,0 +1,246 @@
+// userProcess.c was created by Mark Renard on 10/16/2026.
+//
+// This file contains the decisions of a simulated user process, which sends
+// messages to oss requesting and relinquishing resources at random times. The
+// functions keep all of their state in a UserProcess and draw from the random
+// generator of the calling thread, so many processes can run as threads.
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "dimensions.h"
+#include "perrorExit.h"
+#include "protectedClock.h"
+#include "qMsg.h"
+#include "randomGen.h"
+#include "timerWake.h"
+#include "transport.h"
+#include "userProcess.h"
+
+// Prototypes
+static void declareClaim(UserProcess *);
+static void signalTermination(UserProcess *);
+static bool requestResources(UserProcess *);
+static bool releaseResources(UserProcess *);
+static int getRandomRNum(const UserProcess *);
+static void awaitReply(UserProcess *, MsgBody *);
+static bool aSecondHasPassed(Clock now, Clock startTime);
+
+// Constants
+static const Clock MIN_CHECK = CLOCK(MIN_CHECK_SEC, MIN_CHECK_NS);
+static const Clock MAX_CHECK = CLOCK(MAX_CHECK_SEC, MAX_CHECK_NS);
+static const Clock MIN_RUN_TIME = CLOCK(MIN_RUN_TIME_SEC, 
+					MIN_RUN_TIME_NS);
+static const Clock CLOCK_UPDATE = CLOCK(CLOCK_UPDATE_SEC, 
+					CLOCK_UPDATE_NS);
+
+// Records the shared memory pointers of a process and allocates its arrays
+// if they have not been allocated already
+void initUserProcess(UserProcess * user, int simPid, bool randomClaim,
+		     ProtectedClock * systemClock, ResourceTable * resources,
+		     Message * messages, uint8_t * claims){
+	user->simPid = simPid;
+	user->randomClaim = randomClaim;
+	user->seq = 0;
+	user->suspend = NULL;
+
+	user->systemClock = systemClock;
+	user->resources = resources;
+	user->messages = messages;
+	user->claims = claims;
+
+	if (user->targetHeld == NULL)
+		user->targetHeld = allocArray(NUM_RESOURCES, sizeof(int));
+	if (user->claim == NULL)
+		user->claim = allocArray(NUM_RESOURCES, sizeof(int));
+}
+
+// Requests and releases resources at random times until the process decides
+// to terminate or is killed by oss
+void simulateProcess(UserProcess * user){
+	Clock decisionTime;		// Time to request, relese, or terminate
+	Clock startTime;		// Time the process started
+	Clock now;			// Temp storage for time
+	MsgBody reply;			// Reply from oss
+
+	// Starts holding nothing, as a worker may have simulated a process
+	memset(user->targetHeld, 0, NUM_RESOURCES * sizeof(int));
+
+	declareClaim(user);
+
+	// Initializes clocks
+	startTime = getPTime(user->systemClock);
+	decisionTime = startTime;
+
+	// Repeatedly requests or releases resources or terminates
+	bool terminating = false;
+	bool msgSent = false;	
+	while (!terminating) {
+
+		// Decides when current time is at or after decision time
+		now = getPTime(user->systemClock);
+		if (clockCompare(now, decisionTime) >= 0){
+
+			// Updates decision time
+			incrementClock(&decisionTime, 
+					randomTime(MIN_CHECK, MAX_CHECK));
+
+			// Decides whether to terminate
+			if (aSecondHasPassed(now, startTime) \
+			    && randBinary(TERMINATION_PROBABILITY)){
+				signalTermination(user);
+				terminating = true;
+				msgSent = true;
+
+			// Decides whether to request or release resources
+			} else if (randBinary(REQUEST_PROBABILITY)){
+				msgSent = requestResources(user);
+			} else {
+				msgSent = releaseResources(user);
+			}
+
+			// Increments the protected system clock
+			incrementPClock(user->systemClock, CLOCK_UPDATE);
+
+		// Lets other processes run until the decision time
+		} else if (user->suspend != NULL){
+			user->suspend(user, &decisionTime);
+#ifdef TIMER_WAKE
+		// Sleeps until a clock update reaches the decision time
+		} else {
+			sleepUntil(user->systemClock, user->simPid, 
+				   decisionTime);
+#endif
+		}
+
+		// Waits for response to request
+		if (msgSent){
+			msgSent = false;
+
+			awaitReply(user, &reply);
+
+			if (reply.opcode == OP_KILL){
+
+				terminating = true;
+			}
+		}
+	}
+}
+
+// Blocks until oss replies, or suspends until it has if the process has a
+// suspend function
+static void awaitReply(UserProcess * user, MsgBody * reply){
+	if (user->suspend == NULL){
+		waitForReply(user->simPid, reply);
+		return;
+	}
+
+	while (!pollReply(user->simPid, reply))
+		user->suspend(user, NULL);
+}
+
+// Chooses the most of each resource the process will hold and writes it to its
+// row of the claim matrix, where oss reads it with the first request
+static void declareClaim(UserProcess * user){
+	const ResourceTable * resources = user->resources;
+	uint8_t * row = &user->claims[user->simPid*NUM_RESOURCES];
+	int r;
+	for (r = 0; r < NUM_RESOURCES; r++){
+		if (!user->randomClaim)
+			user->claim[r] = resources->numInstances[r];
+		else if (randBinary(CLAIM_PROBABILITY))
+			user->claim[r] = randInt(1, resources->numInstances[r]);
+		else
+			user->claim[r] = 0;
+
+		row[r] = user->claim[r];
+	}
+}
+
+// Sends a message to oss notifying oss of termination
+static void signalTermination(UserProcess * user){
+	MsgBody msg = newMsgBody(OP_TERMINATE, 0, 0, ++user->seq);
+	sendRequest(user->simPid, &msg);
+}
+
+// Sends a message to oss requesting random resources
+static bool requestResources(UserProcess * user){
+	MsgBody msg;		// Message to send
+	int rNum;		// Resource index
+	int maxRequest;		// Max quantity of requested resources
+	int quantity;		// Actual quantity requested
+
+	// Randomly selects a resource to request
+	rNum = randInt(0, NUM_RESOURCES - 1);
+
+	// Computes maximum request
+	maxRequest = user->claim[rNum] - user->targetHeld[rNum];
+
+	// Returns if none can be requested
+	if (maxRequest == 0) return false;
+
+	// Randomly selects quantity to request
+	quantity = randInt(1, maxRequest);
+
+	// Records new target
+	user->targetHeld[rNum] += quantity;
+
+	// Sends the resource index and quantity in a message
+	msg = newMsgBody(OP_REQUEST, rNum, quantity, ++user->seq);
+	sendRequest(user->simPid, &msg);
+
+	return true;
+
+}
+
+// Sends a message to oss releasing random resources
+static bool releaseResources(UserProcess * user){
+	MsgBody msg;		// Message to send
+	int rNum;		// Resource index
+	int quantity;		// Actual quantity requested
+	
+	// Selects a held resource at random or returns if no resources held
+	if ((rNum = getRandomRNum(user)) == -1){
+
+		 return false;
+	}
+
+	// Randomly determines quantity to release
+	quantity = randInt(1, user->targetHeld[rNum]);
+
+	// Records new target
+	user->targetHeld[rNum] -= quantity;
+
+	// Sends the resource index and quantity in a message
+	msg = newMsgBody(OP_RELEASE, rNum, quantity, ++user->seq);
+	sendRequest(user->simPid, &msg);
+
+	return true;
+
+}
+
+// Gets a randomly chosen index of a held resource or -1 if no resources held
+static int getRandomRNum(const UserProcess * user){
+	int resourceCount;		// Number of resource classes held
+	int resInd[NUM_RESOURCES]; // Indices of held resources
+
+	// Records the indecies of held resources in resInd
+	int i = 0, j = 0;
+	for ( ; i < NUM_RESOURCES; i++)
+		if (user->targetHeld[i] > 0) resInd[j++] = i;
+	resourceCount = j;
+
+	// Returns -1 if no resoures are held
+	if (resourceCount == 0) return -1;
+
+	// Returns the index of the randomly chosen resource
+	return resInd[randInt(0, resourceCount - 1)];
+}
+
+// Returns true if the process has run for at least MIN_RUN_TIME
+static bool aSecondHasPassed(Clock now, Clock startTime){
+	Clock diff = clockDiff(now, startTime);
+	return clockCompare(diff, MIN_RUN_TIME) >= 0;
+}
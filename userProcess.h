@@ -0,0 +1,43 @@
+// userProcess.h was created by Mark Renard on 10/16/2026.
+//
+// This file defines the state of one simulated user process and the function
+// that runs its request/release/terminate decisions. It is used by the
+// userProgram executable and by the threads of oss built with
+// -DTHREADED_USERS.
+
+#ifndef USERPROCESS_H
+#define USERPROCESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "message.h"
+#include "protectedClock.h"
+#include "randomGen.h"
+#include "resourceDescriptor.h"
+
+typedef struct userProcess {
+	int simPid;			// Logical pid of the process
+	bool randomClaim;		// Declares a random claim if true
+	unsigned int seq;		// Sequence number of the last message
+
+	ProtectedClock * systemClock;	// Shared memory system clock
+	ResourceTable * resources;	// Shared memory resource table
+	Message * messages;		// Shared memory message vector
+	uint8_t * claims;		// Shared memory claim matrix
+
+	int * targetHeld;		// Number of each resource to be held
+	int * claim;			// Most of each resource ever to be held
+
+	// Called instead of polling while waiting for the clock to reach
+	// until, or instead of blocking for a reply with until NULL. NULL to
+	// poll and block as a process does.
+	void (*suspend)(struct userProcess *, const Clock * until);
+	RandomState random;		// Generator of a process run by suspend
+} UserProcess;
+
+void initUserProcess(UserProcess *, int simPid, bool randomClaim,
+		     ProtectedClock *, ResourceTable *, Message *, uint8_t *);
+void simulateProcess(UserProcess *);
+
+#endif
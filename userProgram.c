@@ -1,7 +1,9 @@
 // userProgram.c was created by Mark Renard on 4/12/2020
 //
 // This program sends messages to an operating system simulator, simulating a
-// process that requests and relinquishes resources at random times.
+// process that requests and relinquishes resources at random times. When built
+// with -DWORKER_POOL it stays running as the pooled worker for its simPid,
+// simulating a new process each time oss assigns one.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,206 +13,80 @@
 #include <unistd.h>
 
 #include "constants.h"
+#include "dimensions.h"
 #include "getSharedMemoryPointers.h"
 #include "perrorExit.h"
 #include "protectedClock.h"
 #include "qMsg.h"
 #include "randomGen.h"
 #include "sharedMemory.h"
+#include "transport.h"
+#include "userProcess.h"
 
 // Prototypes
-static void signalTermination(int simPid);
-static bool requestResources(ResourceDescriptor *, Message *, int);
-static bool releaseResources(ResourceDescriptor *, Message *, int);
-static int getRandomRNum();
-static bool aSecondHasPassed(Clock now, Clock startTime);
-
-// Constants
-static const Clock MIN_CHECK = {MIN_CHECK_SEC, MIN_CHECK_NS};
-static const Clock MAX_CHECK = {MAX_CHECK_SEC, MAX_CHECK_NS};
-static const Clock MIN_RUN_TIME = {MIN_RUN_TIME_SEC, MIN_RUN_TIME_NS};
-static const Clock CLOCK_UPDATE = {CLOCK_UPDATE_SEC, CLOCK_UPDATE_NS};
+#ifdef WORKER_POOL
+static bool waitForAssignment(int simPid);
+#endif
 
 // Static global
 static char * shm;			// Shared memory region pointer
-static int targetHeld[NUM_RESOURCES];	// Number of each resource to be held
-static int requestMqId;			// Message queue id of request queue
-static int replyMqId;			// Message queue id of reply queue
 
 int main(int argc, char * argv[]){
 	exeName = argv[0];		// Sets exeName for perrorExit
 	int simPid = atoi(argv[1]);	// Gets process's logical pid
-	srand(BASE_SEED + simPid); 	// Seeds pseudorandom number generator
+
+	// Declares a random claim when oss avoids deadlock, otherwise claims all
+	bool randomClaim = argc > 2 && strcmp(argv[2], "-a") == 0;
 
         ProtectedClock * systemClock;	// Shared memory system clock
-        ResourceDescriptor * resources;	// Shared memory resource table
+        ResourceTable resources;	// Shared memory resource table
         Message * messages;		// Shared memory message vector
-
-	Clock decisionTime;		// Time to request, relese, or terminate
-	Clock startTime;		// Time the process started
-	Clock now;			// Temp storage for time
+        uint8_t * claims;		// Shared memory claim matrix
+        Channel * channels;		// Shared memory transport rings
+	UserProcess user = {0};		// State of the simulated process
 
 	// Attatches to shared memory and gets pointers
-	getSharedMemoryPointers(&shm, &systemClock, &resources, &messages, 0);
-
-	// Initializes clocks
-	startTime = getPTime(systemClock);
-	decisionTime = startTime;
-
-	// Gets message queues
-        requestMqId = getMessageQueue(REQUEST_MQ_KEY, MQ_PERMS | IPC_CREAT);
-        replyMqId = getMessageQueue(REPLY_MQ_KEY, MQ_PERMS | IPC_CREAT);
-	char reply[BUFF_SZ];
-
-	// Repeatedly requests or releases resources or terminates
-	bool terminating = false;
-	bool msgSent = false;	
-	while (!terminating) {
-
-		// Decides when current time is at or after decision time
-		now = getPTime(systemClock);
-		if (clockCompare(now, decisionTime) >= 0){
-
-			// Updates decision time
-			incrementClock(&decisionTime, 
-					randomTime(MIN_CHECK, MAX_CHECK));
-
-			// Decides whether to terminate
-			if (aSecondHasPassed(now, startTime) \
-			    && randBinary(TERMINATION_PROBABILITY)){
-				signalTermination(simPid);
-				terminating = true;
-				msgSent = true;
-
-			// Decides whether to request or release resources
-			} else if (randBinary(REQUEST_PROBABILITY)){
-				msgSent = requestResources(resources, messages,
-							   simPid);
-			} else {
-				msgSent = releaseResources(resources, messages,
-							   simPid);
-			}
-
-			// Increments the protected system clock
-			incrementPClock(systemClock, CLOCK_UPDATE);
-		}
-
-		// Waits for response to request
-		if (msgSent){
-			msgSent = false;
-
-			waitForMessage(replyMqId, reply, simPid + 1);
-
-			if (strcmp(reply, KILL_MSG) == 0){
-
-				terminating = true;
-			}
-		}
-	}
-
-	// Prepares to exit
-	detach(shm);
-
-	return 0;
-}
-
-static void signalTermination(int simPid){
-	char msgBuff[BUFF_SZ];
-	sprintf(msgBuff, "0");
-	sendMessage(requestMqId, msgBuff, simPid + 1);
-}
-
-// Sends a message over a message queue requesting random resources
-static bool requestResources(ResourceDescriptor * resources, 
-			     Message * messages, int simPid){
-	char msgBuff[BUFF_SZ];	// Message buffer
-	int rNum;		// Resource index
-	int maxRequest;		// Max quantity of requested resources
-	int quantity;		// Actual quantity requested
-	int encoded;		// Encoded message
-
-	// Randomly selects a resource to request
-	rNum = randInt(0, NUM_RESOURCES - 1);
-
-	// Computes maximum request
-	maxRequest = resources[rNum].numInstances - targetHeld[rNum];
-
-	// Returns if none can be requested
-	if (maxRequest == 0) return false;
-
-	// Randomly selects quantity to request
-	quantity = randInt(1, maxRequest);
+	getSharedMemoryPointers(&shm, &systemClock, &resources, &messages, 
+				&claims, &channels, 0);
 
-	// Records new target
-	targetHeld[rNum] += quantity;
+	// Allocates arrays sized by the dimensions read from shared memory
+	initUserProcess(&user, simPid, randomClaim, systemClock, &resources,
+			messages, claims);
 
-	// Endcodes resource index and quantity in a message
-	encoded = (MAX_INST + 1) * rNum + quantity;
+	// Gets message queues or rings
+	initTransport(channels, false);
 
-	// Sends the message
-	sprintf(msgBuff, "%d", encoded);
-	sendMessage(requestMqId, msgBuff, simPid + 1);
-
-	return true;
-
-}
-
-// Sends a message over a message queue releasing random resources
-static bool releaseResources(ResourceDescriptor * resources,
-			     Message * messages, int simPid){
-	char msgBuff[BUFF_SZ];	// Message buffer
-	int rNum;		// Resource index
-	int quantity;		// Actual quantity requested
-	int encoded;		// Encoded message
-	
-	// Selects a held resource at random or returns if no resources held
-	if ((rNum = getRandomRNum()) == -1){
-
-		 return false;
+#ifndef WORKER_POOL
+	srand(BASE_SEED + simPid); 	// Seeds pseudorandom number generator
+	simulateProcess(&user);
+#else
+	// Simulates a process per assignment, each with its own seed, the
+	// first matching the seed of a process launched without the pool
+	unsigned int generation = 0;
+	while (waitForAssignment(simPid)){
+		srand(BASE_SEED + simPid + generation++ * MAX_RUNNING);
+		simulateProcess(&user);
 	}
+#endif
 
-	// Randomly determines quantity to release
-	quantity = randInt(1, targetHeld[rNum]);
-
-	// Records new target
-	targetHeld[rNum] -= quantity;
-
-	// Encodes resource index and quantity in a message
-	encoded = -((MAX_INST + 1) * rNum + quantity);
-
-	// Sends the message
-	sprintf(msgBuff, "%d", encoded);
-	sendMessage(requestMqId, msgBuff, simPid + 1);
-
-	return true;
+	// Prepares to exit
+	detach(shm);
 
+	return 0;
 }
 
-// Gets a randomly chosen index of a held resource or -1 if no resources held
-static int getRandomRNum(){
-	int resourceCount;		// Number of resource classes held
-	int resInd[NUM_RESOURCES]; // Indices of held resources
+#ifdef WORKER_POOL
+// Blocks until oss assigns a simulated process to this worker, returns false
+// if oss tells the worker to exit instead
+static bool waitForAssignment(int simPid){
+	MsgBody reply;
 
-	// Records the indecies of held resources in resInd
-	int i = 0, j = 0;
-	for ( ; i < NUM_RESOURCES; i++)
-		if (targetHeld[i] > 0) resInd[j++] = i;
-	resourceCount = j;
+	waitForReply(simPid, &reply);
 
-	// Returns -1 if no resoures are held
-	if (resourceCount == 0) return -1;
+	if (reply.opcode == OP_ASSIGN) return true;
+	if (reply.opcode == OP_KILL) return false;
 
-	// Returns the index of the randomly chosen resource
-	return resInd[randInt(0, resourceCount - 1)];
+	perrorExit("waitForAssignment - unexpected opcode");
+	return false;
 }
-
-static bool aSecondHasPassed(Clock now, Clock startTime){
-	static bool hasPassed = false;
-
-	if (!hasPassed){
-		Clock diff = clockDiff(now, startTime);
-		hasPassed = (clockCompare(diff, MIN_RUN_TIME) >= 0);
-	}
-
-	return hasPassed;
-}	
+#endif
@@ -0,0 +1,195 @@
+// victimPolicy.c was created by Mark Renard on 10/16/2026.
+//
+// This file defines the policies used to choose which deadlocked process to
+// kill. Each policy chooses from the candidates in a VictimContext.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "deadlockDetection.h"
+#include "holderIndex.h"
+#include "message.h"
+#include "victimPolicy.h"
+
+// Returns the total number of instances of all resources held by simPid
+static int totalHeld(const VictimContext * c, int simPid){
+	int r, total = 0;
+	for (r = 0; r < NUM_RESOURCES; r++)
+		total += c->allocated[simPid*NUM_RESOURCES + r];
+	return total;
+}
+
+// Kills the first candidate holding enough to meet another candidate's request,
+// otherwise the candidate with the greatest allocation of a requested resource
+static int requestMeetingVictim(const VictimContext * c){
+	ProcessMask others[PROCESS_MASK_WORDS]; // Candidates but the requester
+	int maxAlloc = 0;	// Greatest num allocated of a needed resource
+	int maxPid = -1;	// simPid of process with greatest allocation
+
+	int alloc;		// Allocation of requested resource
+	int p, k;		// Index variables
+
+	processMask(c->candidates, others);
+
+	// Loops through all logical pids
+	for (p = 0; p < MAX_RUNNING; p++){
+		if (!c->candidates[p]) continue;
+		others[p / MASK_BITS] &= ~(1UL << (p % MASK_BITS));
+
+		// Kills the first other candidate that can meet the request
+		k = holderWithAtLeast(c->messages[p].rNum, 
+				      c->messages[p].quantity, others);
+		if (k != -1) return k;
+
+		// Checks for new maximum allocation
+		k = greatestHolder(c->messages[p].rNum, others, &alloc);
+		if (alloc > maxAlloc){
+			maxAlloc = alloc;
+			maxPid = k;
+		}
+
+		others[p / MASK_BITS] |= 1UL << (p % MASK_BITS);
+	}
+
+	// Process with sufficient resources wasn't found
+	return maxPid;
+}
+
+// Kills the candidate holding the fewest instances, but at least one
+static int fewestHeldVictim(const VictimContext * c){
+	int minPid = -1, minHeld = 0, held, p;
+
+	for (p = 0; p < MAX_RUNNING; p++){
+		if (!c->candidates[p] || (held = totalHeld(c, p)) == 0)
+			continue;
+
+		if (minPid == -1 || held < minHeld){
+			minHeld = held;
+			minPid = p;
+		}
+	}
+
+	return minPid != -1 ? minPid : requestMeetingVictim(c);
+}
+
+// Kills the most recently launched candidate holding at least one instance
+static int youngestVictim(const VictimContext * c){
+	int youngest = -1, p;
+
+	for (p = 0; p < MAX_RUNNING; p++){
+		if (!c->candidates[p] || totalHeld(c, p) == 0) continue;
+
+		if (youngest == -1 || clockCompare(c->launchTimes[p],
+				     c->launchTimes[youngest]) > 0)
+			youngest = p;
+	}
+
+	return youngest != -1 ? youngest : requestMeetingVictim(c);
+}
+
+// Searches combinations of size k of the candidates in pids, starting at index
+// first, for a set whose removal ends deadlock. Returns true if one is found,
+// leaving it marked in removed. Stops after *budget evaluations.
+static bool searchKillSets(const int * pids, int count, int first, int k,
+			   int * removed, int * budget){
+	int i;
+
+	if (k == 0){
+		if (*budget <= 0) return false;
+		(*budget)--;
+		return !deadlockedWithout(removed);
+	}
+
+	for (i = first; i <= count - k && *budget > 0; i++){
+		removed[pids[i]] = 1;
+		if (searchKillSets(pids, count, i + 1, k - 1, removed, budget))
+			return true;
+		removed[pids[i]] = 0;
+	}
+
+	return false;
+}
+
+// Finds the smallest set of candidates, up to MAX_KILL_SET, whose deaths end
+// deadlock and kills its member holding the most. Falls back on the request
+// meeting policy if the search is not finished within MAX_KILL_SET_EVALS.
+static int minKillSetVictim(const VictimContext * c){
+	int pids[MAX_RUNNING];		// Candidates holding resources
+	int removed[MAX_RUNNING];	// Candidates in the set being tried
+	int count = 0, budget = MAX_KILL_SET_EVALS;
+	int victim = -1, held, maxHeld = 0;
+	int p, k;
+
+	for (p = 0; p < MAX_RUNNING; p++){
+		removed[p] = 0;
+		if (c->candidates[p] && totalHeld(c, p) > 0) pids[count++] = p;
+	}
+
+	for (k = 1; k <= MAX_KILL_SET && k <= count && budget > 0; k++){
+		if (!searchKillSets(pids, count, 0, k, removed, &budget))
+			continue;
+
+		for (p = 0; p < MAX_RUNNING; p++){
+			if (removed[p] && (held = totalHeld(c, p)) > maxHeld){
+				maxHeld = held;
+				victim = p;
+			}
+		}
+		return victim;
+	}
+
+	return requestMeetingVictim(c);
+}
+
+// Names, descriptions, and functions of the policies, the first is the default
+static const struct {
+	const char * name;
+	const char * description;
+	VictimPolicy choose;
+} policies[] = {
+	{"request", "first process holding enough to meet another's request",
+	 requestMeetingVictim},
+	{"fewest", "process holding the fewest resource instances",
+	 fewestHeldVictim},
+	{"youngest", "most recently launched process", youngestVictim},
+	{"minset", "member of the smallest set of kills that ends deadlock",
+	 minKillSetVictim},
+};
+
+#define NUM_POLICIES (sizeof(policies) / sizeof(policies[0]))
+
+static int selected = 0;	// Index of the selected policy
+
+// Selects the policy with the given name, returns false if there is none
+bool setVictimPolicy(const char * name){
+	int i = 0;
+	for ( ; i < NUM_POLICIES; i++){
+		if (strcmp(name, policies[i].name) == 0){
+			selected = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Returns the name of the selected policy
+const char * victimPolicyName(){
+	return policies[selected].name;
+}
+
+// Prints the names and descriptions of all policies
+void printVictimPolicies(FILE * fp){
+	int i = 0;
+	for ( ; i < NUM_POLICIES; i++)
+		fprintf(fp, "\t%-10s %s\n", policies[i].name,
+			policies[i].description);
+}
+
+// Returns the simPid of the process to kill chosen by the selected policy
+int selectVictim(const VictimContext * context){
+	return policies[selected].choose(context);
+}
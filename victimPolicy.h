@@ -0,0 +1,38 @@
+// victimPolicy.h was created by Mark Renard on 10/16/2026.
+//
+// This file contains headers for the policies used to choose which deadlocked
+// process to kill. The policy is selected by name when oss starts.
+
+#ifndef VICTIMPOLICY_H
+#define VICTIMPOLICY_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "clock.h"
+#include "message.h"
+
+// What a policy knows about the deadlocked system
+typedef struct victimContext {
+	const int * candidates;		// Whether each process may be killed
+	const Message * messages;	// Pending request of each process
+	const int * allocated;		// Live allocation matrix
+	const Clock * launchTimes;	// Time each process was launched
+} VictimContext;
+
+// Returns the simPid of the process to kill, or -1 if none is suitable
+typedef int (*VictimPolicy)(const VictimContext *);
+
+// Selects the policy with the given name, returns false if there is none
+bool setVictimPolicy(const char * name);
+
+// Returns the name of the selected policy
+const char * victimPolicyName();
+
+// Prints the names and descriptions of all policies
+void printVictimPolicies(FILE * fp);
+
+// Returns the simPid of the process to kill chosen by the selected policy
+int selectVictim(const VictimContext * context);
+
+#endif
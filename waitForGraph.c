@@ -0,0 +1,119 @@
+// waitForGraph.c was created by Mark Renard on 10/16/2026.
+//
+// This file maintains a wait-for graph from the waiting queues and allocations
+// of resource classes. A process waiting on a single-instance class has one
+// edge, to the process holding that instance, so following edges from any
+// process either ends at a process that can finish or enters a cycle.
+
+#include <stdbool.h>
+
+#include "constants.h"
+#include "dimensions.h"
+#include "resourceDescriptor.h"
+#include "waitForGraph.h"
+
+#define NONE (-1)		// No class waited on or no holder
+
+// States of a process while the graph is searched
+#define UNVISITED 0
+#define ON_PATH 1
+#define DONE 2
+
+static bool * singleInstance;		   // Class has one unshared instance
+static int * holder;			   // Holder of a single-instance class
+static int * waitingOn;			   // Class each process waits on
+static int multiWaiters = 0;		   // Num waiting on other classes
+
+// Allocates the graph, records the instance counts of each class and clears it
+void initWaitForGraph(const ResourceTable * resources){
+	int i;
+
+	singleInstance = allocArray(NUM_RESOURCES, sizeof(bool));
+	holder = allocArray(NUM_RESOURCES, sizeof(int));
+	waitingOn = allocArray(MAX_RUNNING, sizeof(int));
+
+	for (i = 0; i < NUM_RESOURCES; i++){
+		singleInstance[i] = resources->numInstances[i] == 1 
+				    && !resources->shareable[i];
+		holder[i] = NONE;
+	}
+
+	for (i = 0; i < MAX_RUNNING; i++)
+		waitingOn[i] = NONE;
+
+	multiWaiters = 0;
+}
+
+// Records a change in the number of instances of rNum allocated to simPid
+void graphAllocationChanged(int simPid, int rNum, int before, int after){
+	if (!singleInstance[rNum]) return;
+
+	if (before == 0 && after > 0) holder[rNum] = simPid;
+	else if (before > 0 && after == 0) holder[rNum] = NONE;
+}
+
+// Records that simPid started or stopped waiting on rNum
+void graphWaitChanged(int simPid, int rNum, bool waiting){
+	if (!singleInstance[rNum]) multiWaiters += waiting ? 1 : -1;
+
+	waitingOn[simPid] = waiting ? rNum : NONE;
+}
+
+// Returns true if every waiting process waits on a single-instance class
+bool graphApplies(){
+	return multiWaiters == 0;
+}
+
+// Returns the process simPid waits for, or NONE if it can finish
+static int successor(int simPid){
+	if (waitingOn[simPid] == NONE) return NONE;
+	return holder[waitingOn[simPid]];
+}
+
+// Marks processes that can never finish in deadlocked and those on a cycle in
+// cycle, returns true if there is a cycle
+bool graphDeadlock(int * deadlocked, int * cycle){
+	int state[MAX_RUNNING];	// Search state of each process
+	int path[MAX_RUNNING];	// Processes on the path being followed
+	int length;		// Number of processes on the path
+	bool stuck;		// Whether the path ends in a cycle
+	bool found = false;	// Whether any cycle was found
+	int p, q, i;
+
+	for (p = 0; p < MAX_RUNNING; p++){
+		state[p] = UNVISITED;
+		deadlocked[p] = 0;
+		cycle[p] = 0;
+	}
+
+	for (p = 0; p < MAX_RUNNING; p++){
+		if (state[p] != UNVISITED) continue;
+
+		// Follows edges until reaching a finished search, a process
+		// that can finish, or a process already on the path
+		length = 0;
+		q = p;
+		while (q != NONE && state[q] == UNVISITED){
+			state[q] = ON_PATH;
+			path[length++] = q;
+			q = successor(q);
+		}
+
+		// Marks the processes on a newly found cycle
+		if (q != NONE && state[q] == ON_PATH){
+			found = true;
+			for (i = length - 1; path[i] != q; i--)
+				cycle[path[i]] = 1;
+			cycle[q] = 1;
+		}
+
+		// Every process on the path shares the fate of where it ended
+		stuck = q != NONE && (state[q] == ON_PATH || deadlocked[q]);
+		for (i = 0; i < length; i++){
+			state[path[i]] = DONE;
+			deadlocked[path[i]] = stuck;
+		}
+	}
+
+	return found;
+}
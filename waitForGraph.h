@@ -0,0 +1,29 @@
+// waitForGraph.h was created by Mark Renard on 10/16/2026.
+//
+// This file contains headers for an incrementally maintained wait-for graph,
+// used to detect deadlock by finding cycles when every waiting process waits
+// on a resource class with a single instance.
+
+#ifndef WAITFORGRAPH_H
+#define WAITFORGRAPH_H
+
+#include <stdbool.h>
+#include "resourceDescriptor.h"
+
+// Allocates the graph, records the instance counts of each class and clears it
+void initWaitForGraph(const ResourceTable * resources);
+
+// Records a change in the number of instances of rNum allocated to simPid
+void graphAllocationChanged(int simPid, int rNum, int before, int after);
+
+// Records that simPid started or stopped waiting on rNum
+void graphWaitChanged(int simPid, int rNum, bool waiting);
+
+// Returns true if every waiting process waits on a single-instance class
+bool graphApplies();
+
+// Marks processes that can never finish in deadlocked and those on a cycle in
+// cycle, returns true if there is a cycle. Only valid when graphApplies().
+bool graphDeadlock(int * deadlocked, int * cycle);
+
+#endif